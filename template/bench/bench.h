@@ -0,0 +1,62 @@
+#ifndef _BENCH_HEADER_
+#define _BENCH_HEADER_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "src/string+.h"
+
+/**
+ * @file Helpers shared by the benchmark drivers in 'bench/'. Build and run them all with 'make bench',
+ * or one with 'make bench/<name> && ./bench/<name>'. They are built with '-O2', the main target isn't
+*/
+
+/**
+ * @brief monotonic time in milliseconds
+*/
+static inline double bench_now(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e3 + t.tv_nsec / 1e6;
+}
+
+/**
+ * @brief xorshift64, deterministic so every run measures the same input
+*/
+static inline uint64_t bench_rand(uint64_t *state){
+	uint64_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return *state = x;
+}
+
+/**
+ * @brief size argument 'i' of the command line, 'fallback' if missing
+*/
+static inline size_t bench_arg(int argc, char **argv, int i, size_t fallback){
+	return argc > i ? strtoull(argv[i], NULL, 10) : fallback;
+}
+
+/**
+ * @brief input of 'lines' lines of 'perLine' space separated random integers, about 44 bytes per line with 4 per line
+*/
+static inline string *bench_numbers(size_t lines, size_t perLine){
+	uint64_t seed = 88172645463325252ULL;
+	string *str = string_new_sized(lines * perLine * 11 + 1);
+	char number[32];
+	for(size_t l = 0; l < lines; l++){
+		for(size_t i = 0; i < perLine; i++){
+			int len = snprintf(number, sizeof(number), "%s%lu", i > 0 ? " " : "", bench_rand(&seed) % 10000000000ULL);
+			string_cat_raw(str, number, len);
+		}
+		string_cat_raw(str, "\n", 1);
+	}
+
+	return str;
+}
+
+#endif
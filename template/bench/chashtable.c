@@ -0,0 +1,93 @@
+#include "bench/bench.h"
+#include "src/chashtable.h"
+#include "src/worker.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+typedef struct{
+	chashtable_t *memo;
+	size_t id;
+	size_t lookups;
+	size_t keys;
+	bool failed;
+}bench_task_t;
+
+static atomic_size_t computed;
+static atomic_size_t released;
+
+static void *square(const void *key, size_t keySize, void *context){
+	(void)keySize;
+	(void)context;
+	atomic_fetch_add(&computed, 1);
+	uint64_t *value = malloc(sizeof(uint64_t));
+	*value = *(const uint64_t*)key * *(const uint64_t*)key;
+	return value;
+}
+
+static void release(void *value){
+	atomic_fetch_add(&released, 1);
+	free(value);
+}
+
+// random keys through the memo, every value is checked
+static void *work(void *data){
+	bench_task_t *task = data;
+	uint64_t state = task->id * 7919 + 88172645463325252ULL;
+	for(size_t i = 0; i < task->lookups; i++){
+		uint64_t key = bench_rand(&state) % task->keys;
+		uint64_t *value = chashtable_get_or_compute(task->memo, &key, sizeof(key), square, release, NULL);
+		if(*value != key * key)
+			task->failed = true;
+	}
+	return NULL;
+}
+
+// 'threads' threads on one table, the table doesn't own the values so the race losers go through 'release'
+static double run(size_t threads, size_t shards, size_t lookups, size_t keys){
+	chashtable_t *memo = chashtable_new(shards, false);
+	computed = 0;
+	released = 0;
+
+	bench_task_t tasks[threads];
+	worker_t *workers[threads];
+	double start = bench_now();
+	for(size_t i = 0; i < threads; i++){
+		tasks[i] = (bench_task_t){.memo = memo, .id = i, .lookups = lookups, .keys = keys};
+		workers[i] = workerCreate(work, &tasks[i]);
+	}
+	for(size_t i = 0; i < threads; i++)
+		workerWait(workers[i]);
+	double ms = bench_now() - start;
+
+	// every computed value is either in the table or was released
+	size_t size = chashtable_size(memo);
+	bool failed = size != computed - released;
+	for(size_t i = 0; i < threads; i++)
+		failed |= tasks[i].failed;
+	if(failed){
+		printf("mismatch with %zu threads: %zu values, %zu computed, %zu released\n", threads, size, (size_t)computed, (size_t)released);
+		exit(1);
+	}
+
+	for(uint64_t key = 0; key < keys; key++)
+		free(chashtable_remove_bin(memo, &key, sizeof(key)));
+	chashtable_destroy(memo);
+	return ms;
+}
+
+int main(int argc, char **argv){
+	size_t lookups = bench_arg(argc, argv, 1, 1000000);
+	size_t maxThreads = bench_arg(argc, argv, 2, 8);
+	size_t keys = lookups / 4;
+	printf("chashtable_get_or_compute, %zu lookups per thread over %zu keys, %ld cpus online, Mops/s\n",
+		lookups, keys, sysconf(_SC_NPROCESSORS_ONLN));
+	printf("  %-8s %10s %10s\n", "threads", "1 shard", "64 shards");
+
+	for(size_t threads = 1; threads <= maxThreads; threads *= 2){
+		double one = run(threads, 1, lookups, keys);
+		double sharded = run(threads, CHASHTABLE_SHARDS, lookups, keys);
+		printf("  %-8zu %10.2f %10.2f\n", threads, threads * lookups / (one * 1e3), threads * lookups / (sharded * 1e3));
+	}
+
+	return 0;
+}
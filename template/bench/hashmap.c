@@ -0,0 +1,112 @@
+#include "bench/bench.h"
+#include "src/data.h"
+#include "src/hashmap.h"
+#include "src/matrix.h"
+
+HASHMAP_DEFINE(u64map, uint64_t, uint64_t, hashmap_hash_u64, hashmap_eq_scalar)
+HASHMAP_DEFINE(pointmap, point_t, int, point_hash, point_eq)
+
+// insert 'n' random keys and look them up in another order, with 'hashtable_t' and with a typed map
+static void run_keys(size_t n, uint64_t *state){
+	uint64_t *keys = malloc(n * sizeof(uint64_t));
+	uint64_t *lookups = malloc(n * sizeof(uint64_t));
+	for(size_t i = 0; i < n; i++)
+		keys[i] = lookups[i] = bench_rand(state);
+	for(size_t i = n; i > 1; i--){
+		size_t j = bench_rand(state) % i;
+		uint64_t t = lookups[i - 1];
+		lookups[i - 1] = lookups[j];
+		lookups[j] = t;
+	}
+
+	hashtable_t *h = hashtable_new(16);
+	double start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		hashtable_set_bin(h, &keys[i], sizeof(uint64_t), (void*)(uintptr_t)(keys[i] | 1));
+	double tableInsert = n / ((bench_now() - start) * 1e3);
+
+	uint64_t tableCheck = 0;
+	start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		tableCheck += (uintptr_t)hashtable_get_bin(h, &lookups[i], sizeof(uint64_t));
+	double tableHit = n / ((bench_now() - start) * 1e3);
+	hashtable_destroy(h);
+
+	u64map_t *m = u64map_new(0);
+	start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		u64map_set(m, keys[i], keys[i] | 1);
+	double mapInsert = n / ((bench_now() - start) * 1e3);
+
+	uint64_t mapCheck = 0;
+	start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		mapCheck += *u64map_get(m, lookups[i]);
+	double mapHit = n / ((bench_now() - start) * 1e3);
+	u64map_destroy(m);
+
+	if(tableCheck != mapCheck){
+		printf("mismatch with %zu keys\n", n);
+		exit(1);
+	}
+
+	printf("  %-10zu %7.2f %7.2f   %7.2f %7.2f\n", n, tableInsert, tableHit, mapInsert, mapHit);
+	free(keys);
+	free(lookups);
+}
+
+// random walk on a grid counting the visits of every cell, the usual counter keyed by points
+static void run_walk(size_t steps, size_t side, uint64_t *state){
+	point_t *path = malloc(steps * sizeof(point_t));
+	point_t p = {side / 2, side / 2};
+	for(size_t i = 0; i < steps; i++){
+		uint64_t r = bench_rand(state) & 3;
+		if(r == 0 && p.y > 0) p.y--;
+		if(r == 1 && p.y < side - 1) p.y++;
+		if(r == 2 && p.x > 0) p.x--;
+		if(r == 3 && p.x < side - 1) p.x++;
+		path[i] = p;
+	}
+
+	hashtable_t *h = hashtable_new(16);
+	double start = bench_now();
+	for(size_t i = 0; i < steps; i++){
+		uintptr_t count = (uintptr_t)hashtable_get_bin(h, &path[i], sizeof(point_t));
+		hashtable_set_bin(h, &path[i], sizeof(point_t), (void*)(count + 1));
+	}
+	double tableMops = steps / ((bench_now() - start) * 1e3);
+	size_t tableCells = hashtable_size(h);
+	hashtable_destroy(h);
+
+	pointmap_t *m = pointmap_new(0);
+	start = bench_now();
+	for(size_t i = 0; i < steps; i++)
+		(*pointmap_put(m, path[i], NULL))++;
+	double mapMops = steps / ((bench_now() - start) * 1e3);
+	size_t mapCells = pointmap_size(m);
+	pointmap_destroy(m);
+
+	if(tableCells != mapCells){
+		printf("mismatch: %zu cells visited vs %zu\n", tableCells, mapCells);
+		exit(1);
+	}
+
+	printf("visits on a %zux%zu grid, %zu steps, %zu cells: hashtable_t get+set %.2f Mops/s, pointmap_put %.2f Mops/s\n",
+		side, side, steps, mapCells, tableMops, mapMops);
+	free(path);
+}
+
+int main(int argc, char **argv){
+	size_t max = bench_arg(argc, argv, 1, 1000000);
+	size_t steps = bench_arg(argc, argv, 2, 10000000);
+	uint64_t state = 88172645463325252ULL;
+
+	printf("hashtable_t vs HASHMAP_DEFINE, random uint64 keys, Mops/s\n");
+	printf("  %-10s %15s   %15s\n", "", "hashtable_t", "u64map");
+	printf("  %-10s %7s %7s   %7s %7s\n", "keys", "insert", "hit", "insert", "hit");
+	for(size_t n = 100000; n <= max; n *= 10)
+		run_keys(n, &state);
+
+	run_walk(steps, 1000, &state);
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include "bench/bench.h"
+#include "src/data.h"
+#include "src/hash.h"
+
+// the hashtable before open addressing: a fixed array of buckets, every key in it's own malloc'd node with a malloc'd key copy
+typedef struct old_node_t old_node_t;
+struct old_node_t{
+	void *value;
+	old_node_t *next;
+	void *key;
+	size_t keySize;
+};
+
+typedef struct{
+	old_node_t **values;
+	size_t size;
+}old_table_t;
+
+static old_table_t *old_new(size_t size){
+	old_table_t *h = malloc(sizeof(old_table_t));
+	h->size = size;
+	h->values = calloc(size, sizeof(old_node_t*));
+	return h;
+}
+
+static void old_set(old_table_t *h, const void *key, size_t keySize, void *value){
+	old_node_t **cursor = &h->values[djb2_hash(key, keySize) % h->size];
+	for(; *cursor != NULL; cursor = &(*cursor)->next)
+		if((*cursor)->keySize == keySize && !memcmp((*cursor)->key, key, keySize))
+			return;
+
+	old_node_t *node = malloc(sizeof(old_node_t));
+	node->key = malloc(keySize);
+	memcpy(node->key, key, keySize);
+	node->keySize = keySize;
+	node->value = value;
+	node->next = NULL;
+	*cursor = node;
+}
+
+static void *old_get(old_table_t *h, const void *key, size_t keySize){
+	for(old_node_t *node = h->values[djb2_hash(key, keySize) % h->size]; node != NULL; node = node->next)
+		if(node->keySize == keySize && !memcmp(node->key, key, keySize))
+			return node->value;
+	return NULL;
+}
+
+static void old_destroy(old_table_t *h){
+	for(size_t i = 0; i < h->size; i++)
+		for(old_node_t *node = h->values[i]; node != NULL;){
+			old_node_t *next = node->next;
+			free(node->key);
+			free(node);
+			node = next;
+		}
+	free(h->values);
+	free(h);
+}
+
+typedef struct{
+	double insert;
+	double hit;
+	double miss;
+	uint64_t check;
+}result_t;
+
+// insert 'keys', look them up in another order, then look up keys that aren't there. Old table when 'buckets' isn't 0
+static result_t run(uint64_t *keys, uint64_t *lookups, uint64_t *missing, size_t n, size_t buckets){
+	result_t r = {0};
+	hashtable_t *h = buckets == 0 ? hashtable_new(16) : NULL;
+	old_table_t *old = buckets != 0 ? old_new(buckets) : NULL;
+
+	double start = bench_now();
+	for(size_t i = 0; i < n; i++){
+		if(h != NULL) hashtable_set_bin(h, &keys[i], sizeof(uint64_t), (void*)(uintptr_t)(i + 1));
+		else old_set(old, &keys[i], sizeof(uint64_t), (void*)(uintptr_t)(i + 1));
+	}
+	r.insert = n / ((bench_now() - start) * 1e3);
+
+	start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		r.check += (uintptr_t)(h != NULL ? hashtable_get_bin(h, &lookups[i], sizeof(uint64_t)) : old_get(old, &lookups[i], sizeof(uint64_t)));
+	r.hit = n / ((bench_now() - start) * 1e3);
+
+	start = bench_now();
+	for(size_t i = 0; i < n; i++)
+		r.check += (uintptr_t)(h != NULL ? hashtable_get_bin(h, &missing[i], sizeof(uint64_t)) : old_get(old, &missing[i], sizeof(uint64_t)));
+	r.miss = n / ((bench_now() - start) * 1e3);
+
+	if(h != NULL) hashtable_destroy(h);
+	else old_destroy(old);
+	return r;
+}
+
+int main(int argc, char **argv){
+	size_t n = bench_arg(argc, argv, 1, 1000000);
+	size_t buckets = bench_arg(argc, argv, 2, 1 << 20);
+
+	// odd keys are inserted, even keys are the misses
+	uint64_t state = 88172645463325252ULL;
+	uint64_t *keys = malloc(n * sizeof(uint64_t));
+	uint64_t *lookups = malloc(n * sizeof(uint64_t));
+	uint64_t *missing = malloc(n * sizeof(uint64_t));
+	for(size_t i = 0; i < n; i++){
+		keys[i] = bench_rand(&state) | 1;
+		missing[i] = bench_rand(&state) & ~1ULL;
+	}
+	memcpy(lookups, keys, n * sizeof(uint64_t));
+	for(size_t i = n; i > 1; i--){
+		size_t j = bench_rand(&state) % i;
+		uint64_t t = lookups[i - 1];
+		lookups[i - 1] = lookups[j];
+		lookups[j] = t;
+	}
+
+	printf("hashtable, %zu random uint64 keys, Mops/s\n", n);
+	printf("  %-34s %7s %7s %7s\n", "", "insert", "hit", "miss");
+	result_t now = run(keys, lookups, missing, n, 0);
+	printf("  %-34s %7.2f %7.2f %7.2f\n", "open addressing, grows from 16", now.insert, now.hit, now.miss);
+	result_t old = run(keys, lookups, missing, n, buckets);
+	char label[64];
+	snprintf(label, sizeof(label), "old chained, %zu buckets", buckets);
+	printf("  %-34s %7.2f %7.2f %7.2f\n", label, old.insert, old.hit, old.miss);
+	if(now.check != old.check){
+		printf("mismatch: the tables found different values\n");
+		return 1;
+	}
+
+	free(keys);
+	free(lookups);
+	free(missing);
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench/bench.h"
+#include "src/data.h"
+#include "src/heap.h"
+
+// min order: 'b' goes before 'a' when it's smaller
+static cmp_t int_cmp(void *a, void *b){
+	return *(int*)b < *(int*)a ? cmp_left : cmp_right;
+}
+
+// push 'n' values then pop them all, the popped values are checked to come out sorted
+static double run(int *values, size_t n, bool list, uint64_t *check){
+	double start = bench_now();
+	list_t *l = list ? list_new_custom_queue(false, int_cmp) : NULL;
+	heap_t *h = list ? NULL : heap_new(int_cmp);
+	for(size_t i = 0; i < n; i++){
+		if(list) list_push(l, &values[i]);
+		else heap_push(h, &values[i]);
+	}
+
+	int last = INT32_MIN;
+	*check = 0;
+	for(size_t i = 0; i < n; i++){
+		int value = *(int*)(list ? list_pop(l) : heap_pop(h));
+		if(value < last){
+			printf("out of order after %zu pops\n", i);
+			exit(1);
+		}
+		last = value;
+		*check = *check * 31 + value;
+	}
+
+	if(list) list_destroy(l);
+	else heap_destroy(h);
+	return bench_now() - start;
+}
+
+int main(int argc, char **argv){
+	size_t listMax = bench_arg(argc, argv, 1, 20000);
+	size_t heapMax = bench_arg(argc, argv, 2, 1000000);
+
+	uint64_t state = 88172645463325252ULL;
+	int *values = malloc(heapMax * sizeof(int));
+	for(size_t i = 0; i < heapMax; i++)
+		values[i] = bench_rand(&state) % 1000000000;
+
+	printf("priority queues, push then pop of random ints, min order\n");
+	printf("  %-10s %12s %12s\n", "n", "list queue", "heap");
+	size_t sizes[] = {5000, 10000, 20000, 50000, 100000, 1000000, 10000000};
+	for(size_t i = 0; i < sizeof(sizes) / sizeof(*sizes) && sizes[i] <= heapMax; i++){
+		size_t n = sizes[i];
+		uint64_t heapCheck, listCheck;
+		double heapMs = run(values, n, false, &heapCheck);
+		if(n > listMax){
+			printf("  %-10zu %12s %9.1f ms\n", n, "-", heapMs);
+			continue;
+		}
+
+		double listMs = run(values, n, true, &listCheck);
+		if(heapCheck != listCheck){
+			printf("mismatch with %zu values\n", n);
+			return 1;
+		}
+		printf("  %-10zu %9.1f ms %9.1f ms\n", n, listMs, heapMs);
+	}
+
+	free(values);
+	return 0;
+}
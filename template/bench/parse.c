@@ -0,0 +1,64 @@
+#include "bench/bench.h"
+#include "src/ite.h"
+#include "src/parse.h"
+#include <unistd.h>
+
+// sum of the numbers of the line, allocated like the values of a real solution
+static void parse_line(const string *line, array_t *out, void *context){
+	(void)context;
+	int64_t values[16];
+	size_t count = string_parse_ints(line, values, 16);
+	int64_t *sum = malloc(sizeof(int64_t));
+	*sum = 0;
+	for(size_t i = 0; i < count; i++)
+		*sum += values[i];
+	array_add(out, sum);
+}
+
+// the single threaded loop parse_lines_parallel replaces
+static array_t *parse_serial(const string *data){
+	array_t *out = array_new_custom(false, MIN_ARRAY_BLOCK_SIZE + data->len / PARSE_EXPECTED_LINE_SIZE);
+	string_ite ite = string_split(data, "\n");
+	foreach(string, line, ite)
+		parse_line(&line, out, NULL);
+	return out;
+}
+
+static void release(array_t *a){
+	for(size_t i = 0; i < array_size(a); i++)
+		free(array_get(a, i));
+	array_destroy(a);
+}
+
+int main(int argc, char **argv){
+	size_t lines = bench_arg(argc, argv, 1, 1000000);
+	size_t maxThreads = bench_arg(argc, argv, 2, 8);
+	string *data = bench_numbers(lines, 4);
+	printf("parse_lines_parallel, %zu lines, %.1f MB, %ld cpus online\n", lines, data->len / 1e6, sysconf(_SC_NPROCESSORS_ONLN));
+
+	double start = bench_now();
+	array_t *expected = parse_serial(data);
+	double serialMs = bench_now() - start;
+	printf("  serial     %7.1f ms\n", serialMs);
+
+	for(size_t threads = 1; threads <= maxThreads; threads *= 2){
+		start = bench_now();
+		array_t *out = parse_lines_parallel(data, threads, parse_line, NULL);
+		double ms = bench_now() - start;
+
+		bool same = array_size(out) == array_size(expected);
+		for(size_t i = 0; same && i < array_size(out); i++)
+			same = *(int64_t*)array_get(out, i) == *(int64_t*)array_get(expected, i);
+		if(!same){
+			printf("mismatch with %zu threads\n", threads);
+			return 1;
+		}
+
+		printf("  %2zu threads %7.1f ms   %.2fx\n", threads, ms, serialMs / ms);
+		release(out);
+	}
+
+	release(expected);
+	string_destroy(data);
+	return 0;
+}
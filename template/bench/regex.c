@@ -0,0 +1,128 @@
+#include "bench/bench.h"
+#include "src/regex_dfa.h"
+
+// the built in engine against glibc on the same patterns, '\d' and the other shorthands are written as POSIX classes for regcomp
+static const char *patterns[][2] = {
+	{"\\d+", "[[:digit:]]+"},
+	{"\\D+", "[^[:digit:]]+"},
+	{"\\w+", "[[:alnum:]_]+"},
+	{"\\W+", "[^[:alnum:]_]+"},
+	{"\\s+", "[[:space:]]+"},
+	{"\\S+", "[^[:space:]]+"},
+	{"[^0-9]+", "[^0-9]+"},
+	{".+", ".+"},
+	{"(\\w+)-(\\d+)", "([[:alnum:]_]+)-([[:digit:]]+)"},
+	{"a|ab|abc", "a|ab|abc"},
+	{"x*", "x*"},
+	{"[a-c]{2,3}\\W?", "[a-c]{2,3}[^[:alnum:]_]?"},
+};
+
+static const char *texts[] = {
+	"ab\ncd",
+	"ab\n\ncd 12\n",
+	"\n",
+	"abc-123 def-4\nx_y-56, zz\t9\n",
+	"  \n  \t\n",
+	"",
+	"abcabc\nab!cab ?",
+};
+
+// every match of 're' and 'posix' over 'text' must be the same, searching again after each match like the string_match iterator
+static bool check(regex_dfa_t *re, regex_t *posix, const char *text){
+	size_t len = strlen(text);
+	size_t offset = 0;
+	while(offset <= len){
+		regmatch_t a = {0}, b = {0};
+		int dfa = regex_dfa_exec(re, text + offset, len - offset, 1, &a);
+
+		b.rm_so = offset;
+		b.rm_eo = len;
+		int libc = regexec(posix, text, 1, &b, REG_STARTEND);
+		if(libc == 0){
+			b.rm_so -= offset;
+			b.rm_eo -= offset;
+		}
+
+		if(dfa != libc || (dfa == 0 && (a.rm_so != b.rm_so || a.rm_eo != b.rm_eo)))
+			return false;
+		if(dfa != 0)
+			break;
+
+		offset += a.rm_eo > 0 ? a.rm_eo : 1;
+	}
+	return true;
+}
+
+// count the matches over the whole data, with either engine
+static double run(regex_dfa_t *re, regex_t *posix, const string *data, size_t *count){
+	double start = bench_now();
+	*count = 0;
+	for(size_t offset = 0; offset < data->len;){
+		regmatch_t m = {.rm_so = offset, .rm_eo = data->len};
+		if(re != NULL){
+			if(regex_dfa_exec(re, data->raw + offset, data->len - offset, 1, &m) != 0) break;
+			m.rm_so += offset;
+			m.rm_eo += offset;
+		}
+		else if(regexec(posix, data->raw, 1, &m, REG_STARTEND) != 0)
+			break;
+
+		(*count)++;
+		offset = m.rm_eo > m.rm_so ? (size_t)m.rm_eo : (size_t)m.rm_so + 1;
+	}
+	return bench_now() - start;
+}
+
+int main(int argc, char **argv){
+	size_t failed = 0;
+	for(size_t i = 0; i < sizeof(patterns) / sizeof(*patterns); i++){
+		regex_dfa_t *re = regex_dfa_compile(patterns[i][0]);
+		regex_t posix;
+		if(re == NULL || regcomp(&posix, patterns[i][1], REG_EXTENDED | REG_NEWLINE) != 0){
+			printf("can't compile '%s'\n", patterns[i][0]);
+			return 1;
+		}
+
+		for(size_t j = 0; j < sizeof(texts) / sizeof(*texts); j++)
+			if(!check(re, &posix, texts[j])){
+				printf("mismatch: '%s' on text %zu\n", patterns[i][0], j);
+				failed++;
+			}
+
+		regex_dfa_destroy(re);
+		regfree(&posix);
+	}
+	if(failed > 0)
+		return 1;
+	printf("regex_dfa, %zu patterns agree with regexec\n", sizeof(patterns) / sizeof(*patterns));
+
+	size_t lines = bench_arg(argc, argv, 1, 100000);
+	string *data = bench_numbers(lines, 4);
+	printf("regex_dfa, %zu lines, %.1f MB\n", lines, data->len / 1e6);
+
+	const char *timed[][2] = {
+		{"\\d+", "[[:digit:]]+"},
+		{"\\d+ \\d+", "[[:digit:]]+ [[:digit:]]+"},
+		{"\\S+\\s", "[^[:space:]]+[[:space:]]"},
+	};
+	for(size_t i = 0; i < sizeof(timed) / sizeof(*timed); i++){
+		regex_dfa_t *re = regex_dfa_compile(timed[i][0]);
+		regex_t posix;
+		regcomp(&posix, timed[i][1], REG_EXTENDED | REG_NEWLINE);
+
+		size_t dfaCount, libcCount;
+		double dfaMs = run(re, NULL, data, &dfaCount);
+		double libcMs = run(NULL, &posix, data, &libcCount);
+		if(dfaCount != libcCount){
+			printf("mismatch on '%s': %zu matches vs %zu\n", timed[i][0], dfaCount, libcCount);
+			return 1;
+		}
+
+		printf("  %-12s %9zu matches   dfa %7.1f ms   regexec %7.1f ms\n", timed[i][0], dfaCount, dfaMs, libcMs);
+		regex_dfa_destroy(re);
+		regfree(&posix);
+	}
+
+	string_destroy(data);
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include "bench/bench.h"
+#include "src/sort.h"
+#include <unistd.h>
+
+typedef struct{
+	uint32_t y;
+	uint32_t x;
+	uint32_t id;
+}bench_point_t;
+
+#define u64_less(a, b) ((a) < (b))
+SORT_DEFINE(sort_u64, uint64_t, u64_less)
+
+static int qsort_u64(const void *a, const void *b){
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static int qsort_u32(const void *a, const void *b){
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+static int point_order(const void *a, const void *b){
+	const bench_point_t *p = a;
+	const bench_point_t *q = b;
+	return (p->y > q->y) - (p->y < q->y);
+}
+
+static int qsort_point(const void *a, const void *b){
+	return point_order(*(void* const*)a, *(void* const*)b);
+}
+
+static uint64_t point_key(const void *element){
+	return ((const bench_point_t*)element)->y;
+}
+
+static void report(const char *name, double ms, bool sorted){
+	if(!sorted){
+		printf("%s: wrong order\n", name);
+		exit(1);
+	}
+	printf("  %-24s %9.1f ms\n", name, ms);
+}
+
+// the points sorted by 'y', ties in input order when 'stable'
+static bool points_sorted(bench_point_t **points, size_t n, bool stable){
+	for(size_t i = 1; i < n; i++)
+		if(points[i - 1]->y > points[i]->y || (stable && points[i - 1]->y == points[i]->y && points[i - 1]->id > points[i]->id))
+			return false;
+	return true;
+}
+
+int main(int argc, char **argv){
+	size_t n = bench_arg(argc, argv, 1, 1000000);
+	size_t maxThreads = bench_arg(argc, argv, 2, 4);
+	printf("sort, %zu random values, %ld cpus online\n", n, sysconf(_SC_NPROCESSORS_ONLN));
+
+	uint64_t state = 88172645463325252ULL;
+	uint64_t *input = malloc(n * sizeof(uint64_t));
+	uint64_t *expected = malloc(n * sizeof(uint64_t));
+	uint64_t *data = malloc(n * sizeof(uint64_t));
+	for(size_t i = 0; i < n; i++)
+		input[i] = bench_rand(&state);
+
+	// integers, checked against qsort
+	memcpy(expected, input, n * sizeof(uint64_t));
+	double start = bench_now();
+	qsort(expected, n, sizeof(uint64_t), qsort_u64);
+	report("qsort u64", bench_now() - start, true);
+
+	memcpy(data, input, n * sizeof(uint64_t));
+	start = bench_now();
+	sort_u64(data, n);
+	report("SORT_DEFINE u64", bench_now() - start, !memcmp(data, expected, n * sizeof(uint64_t)));
+
+	memcpy(data, input, n * sizeof(uint64_t));
+	start = bench_now();
+	sort_radix_u64(data, n);
+	report("radix u64", bench_now() - start, !memcmp(data, expected, n * sizeof(uint64_t)));
+
+	uint32_t *expected32 = (uint32_t*)expected;
+	uint32_t *data32 = (uint32_t*)data;
+	for(size_t i = 0; i < n; i++)
+		expected32[i] = data32[i] = (uint32_t)input[i];
+	qsort(expected32, n, sizeof(uint32_t), qsort_u32);
+	start = bench_now();
+	sort_radix_u32(data32, n);
+	report("radix u32", bench_now() - start, !memcmp(data32, expected32, n * sizeof(uint32_t)));
+
+	// 12 byte structs with many equal keys, through pointers and by key
+	bench_point_t *points = malloc(n * sizeof(bench_point_t));
+	bench_point_t **pointers = malloc(n * sizeof(bench_point_t*));
+	bench_point_t **sorted = malloc(n * sizeof(bench_point_t*));
+	for(size_t i = 0; i < n; i++){
+		points[i] = (bench_point_t){.y = bench_rand(&state) % (n / 4 + 1), .x = 0, .id = i};
+		pointers[i] = &points[i];
+	}
+
+	memcpy(sorted, pointers, n * sizeof(void*));
+	start = bench_now();
+	qsort(sorted, n, sizeof(void*), qsort_point);
+	report("qsort pointers", bench_now() - start, points_sorted(sorted, n, false));
+
+	for(size_t threads = 1; threads <= maxThreads; threads *= 2){
+		char name[32];
+		snprintf(name, sizeof(name), "merge pointers %zu threads", threads);
+		memcpy(sorted, pointers, n * sizeof(void*));
+		start = bench_now();
+		sort_pointers((void**)sorted, n, point_order, threads);
+		report(name, bench_now() - start, points_sorted(sorted, n, true));
+	}
+
+	start = bench_now();
+	sort_radix_by_key(points, n, sizeof(bench_point_t), point_key);
+	double ms = bench_now() - start;
+	for(size_t i = 0; i < n; i++)
+		sorted[i] = &points[i];
+	report("radix by key", ms, points_sorted(sorted, n, true));
+
+	free(input);
+	free(expected);
+	free(data);
+	free(points);
+	free(pointers);
+	free(sorted);
+	return 0;
+}
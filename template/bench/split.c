@@ -0,0 +1,71 @@
+#include "bench/bench.h"
+#include "src/ite.h"
+
+// string_split before the token sets were compiled: strspn/strcspn on every token, the string must be null terminated
+static string old_split_next(string_ite *iterator){
+	size_t start = strspn(iterator->state, iterator->tokens);
+	size_t end = strcspn(iterator->state + start, iterator->tokens);
+
+	if(end == 0 || iterator->state + start >= iterator->base + iterator->max){
+		iterator->yield = false;
+		return (string){0};
+	}
+
+	if(iterator->state + start + end > iterator->base + iterator->max)
+		end = iterator->base + iterator->max - (iterator->state + start);
+
+	string slice = (string){
+		.raw = iterator->state + start,
+		.len = end
+	};
+
+	iterator->state += start + end;
+	return slice;
+}
+
+static string_ite old_split(const string *str, const char *tokens){
+	return (string_ite){
+		.state = str->raw,
+		.base = str->raw,
+		.max = str->len,
+		.tokens = tokens,
+		.next = old_split_next,
+		.yield = true
+	};
+}
+
+// count tokens and sum their lengths, so both versions can be compared and nothing is optimized out
+static double run(const string *data, const char *tokens, bool old, size_t *count, size_t *bytes){
+	double start = bench_now();
+	string_ite ite = old ? old_split(data, tokens) : string_split(data, tokens);
+	*count = 0;
+	*bytes = 0;
+	foreach(string, token, ite){
+		(*count)++;
+		*bytes += token.len;
+	}
+	return bench_now() - start;
+}
+
+int main(int argc, char **argv){
+	size_t lines = bench_arg(argc, argv, 1, 1000000);
+	string *data = bench_numbers(lines, 4);
+	printf("string_split, %zu lines, %.1f MB\n", lines, data->len / 1e6);
+
+	const char *sets[] = {"\n", " ", " \n", " \n,;:-x"};
+	const char *names[] = {"'\\n'", "' '", "' \\n'", "7 tokens"};
+	for(size_t i = 0; i < sizeof(sets) / sizeof(*sets); i++){
+		size_t newCount, newBytes, oldCount, oldBytes;
+		double newMs = run(data, sets[i], false, &newCount, &newBytes);
+		double oldMs = run(data, sets[i], true, &oldCount, &oldBytes);
+		if(newCount != oldCount || newBytes != oldBytes){
+			printf("mismatch on %s: %zu tokens vs %zu\n", names[i], newCount, oldCount);
+			return 1;
+		}
+
+		printf("  %-10s %9zu tokens   new %7.1f ms   old %7.1f ms\n", names[i], newCount, newMs, oldMs);
+	}
+
+	string_destroy(data);
+	return 0;
+}
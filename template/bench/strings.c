@@ -0,0 +1,65 @@
+#include "bench/bench.h"
+#include "src/ite.h"
+
+typedef enum{
+	copy_separate,											/**< header and buffer allocated apart, like before the buffer was inlined */
+	copy_together,											/**< 'string_copy', one allocation */
+	copy_buffer												/**< 'string_with_buffer' on a stack array, no allocation */
+}copy_mode_t;
+
+// copy every token and release it, the first byte of each copy is summed so nothing is optimized out
+static double run(const string *data, copy_mode_t mode, size_t *count, uint64_t *check){
+	double start = bench_now();
+	string_ite ite = string_split(data, " \n");
+	*count = 0;
+	*check = 0;
+	foreach(string, token, ite){
+		if(mode == copy_separate){
+			string *copy = string_wrap(strndup(token.raw, token.len), true);
+			*check += (uint8_t)copy->raw[0] + copy->len;
+			string_destroy(copy);
+		}
+		else if(mode == copy_together){
+			string *copy = string_copy(&token);
+			*check += (uint8_t)copy->raw[0] + copy->len;
+			string_destroy(copy);
+		}
+		else{
+			char buffer[32];
+			string copy = string_with_buffer(buffer, sizeof(buffer));
+			string_cat(&copy, &token, 0);
+			*check += (uint8_t)copy.raw[0] + copy.len;
+			string_free(&copy);
+		}
+		(*count)++;
+	}
+	return bench_now() - start;
+}
+
+int main(int argc, char **argv){
+	size_t lines = bench_arg(argc, argv, 1, 1000000);
+	string *data = bench_numbers(lines, 4);
+	printf("string copies, %zu lines, %.1f MB\n", lines, data->len / 1e6);
+
+	const char *names[] = {"header + buffer (2 allocations)", "string_copy (1 allocation)", "string_with_buffer (0 allocations)"};
+	size_t expectedCount = 0;
+	uint64_t expectedCheck = 0;
+	for(copy_mode_t mode = copy_separate; mode <= copy_buffer; mode++){
+		size_t count;
+		uint64_t check;
+		double ms = run(data, mode, &count, &check);
+		if(mode == copy_separate){
+			expectedCount = count;
+			expectedCheck = check;
+		}
+		else if(count != expectedCount || check != expectedCheck){
+			printf("mismatch on %s\n", names[mode]);
+			return 1;
+		}
+
+		printf("  %-36s %9zu tokens %7.1f ms\n", names[mode], count, ms);
+	}
+
+	string_destroy(data);
+	return 0;
+}
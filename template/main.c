@@ -12,22 +12,29 @@
 #include "src/hash.h"
 #include "src/data.h"
 #include "src/ite.h"
+#include "src/arena.h"
+#include "src/parse.h"
 
 typedef struct{
 	
 }puzzle_t;
 
-// parse file
-puzzle_t *parseInput(const string *data){
-	puzzle_t *p = calloc(1, sizeof(puzzle_t));
+// parse a line, called in parallel from many threads. Push the parsed values to 'out'
+void parseLine(const string *line, array_t *out, void *context){
+	
+}
+
+// parse file, everything is allocated from the arena and released at once
+puzzle_t *parseInput(arena_t *arena, const string *data){
+	puzzle_t *p = arena_calloc(arena, 1, sizeof(puzzle_t));
 
-	string_ite ite = string_split(data, "\n");
-	size_t lnumber = 0;
-	for(string line = next(ite); yield(ite); line = next(ite)){
+	// values of every line, in input order
+	array_t *values = parse_lines_parallel(data, 0, parseLine, p);
+	for(size_t i = 0; i < array_size(values); i++){
 		
-		lnumber++;
 	}
 	
+	array_destroy(values);
 	return p;
 }
 
@@ -41,14 +48,16 @@ uint64_t part2(puzzle_t *p){
 
 int main(int argc, char**argv){
 	string *data;
-	if(argc > 1) data = string_from_filename(argv[1], NULL);	// from arg filename
+	if(argc > 1) data = string_map_filename(argv[1], NULL, string_map_populate | string_map_sequential);	// from arg filename
 	else         data = string_from_file(stdin, NULL);      	// from pipe
 
-	puzzle_t *p = parseInput(data);
+	arena_t *arena = arena_new();
+	puzzle_t *p = parseInput(arena, data);
 	
 	printf("Part 1: %lu\n", part1(p));
 	printf("Part 2: %lu\n", part2(p));
 
+	arena_destroy(arena);
 	string_destroy(data);
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "arena.h"
+
+// ------------------------------------------------------------ Arena --------------------------------------------------------------
+
+arena_t *arena_new_custom(size_t blockSize){
+	arena_t *a = calloc(1, sizeof(arena_t));
+	a->blockSize = blockSize > 0 ? blockSize : ARENA_BLOCK_SIZE;
+	return a;
+}
+
+arena_t *arena_new(void){
+	return arena_new_custom(ARENA_BLOCK_SIZE);
+}
+
+void arena_destroy(arena_t *a){
+	if(a == NULL) return;
+
+	arena_block_t *block = a->block;
+	while(block != NULL){
+		arena_block_t *prev = block->prev;
+		free(block);
+		block = prev;
+	}
+
+	free(a);
+}
+
+// !trivial
+static size_t arena_align(size_t size){
+	return (size + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// !trivial
+void *arena_alloc(arena_t *a, size_t size){
+	size = arena_align(size > 0 ? size : 1);
+
+	arena_block_t *block = a->block;
+	if(block == NULL || block->used + size > block->size){
+		size_t blockSize = size > a->blockSize ? size : a->blockSize;
+		block = malloc(sizeof(arena_block_t) + blockSize);
+		if(block == NULL) return NULL;
+
+		block->prev = a->block;
+		block->size = blockSize;
+		block->used = 0;
+		a->block = block;
+	}
+
+	void *ptr = block->data + block->used;
+	block->used += size;
+	a->allocated += size;
+	return ptr;
+}
+
+void *arena_calloc(arena_t *a, size_t count, size_t size){
+	void *ptr = arena_alloc(a, count * size);
+	if(ptr != NULL)
+		memset(ptr, 0, count * size);
+
+	return ptr;
+}
+
+// !trivial
+void *arena_realloc(arena_t *a, void *ptr, size_t oldSize, size_t size){
+	if(ptr == NULL) return arena_alloc(a, size);
+
+	// last allocation of the current block, resize in place
+	arena_block_t *block = a->block;
+	size_t old = arena_align(oldSize > 0 ? oldSize : 1);
+	if(block != NULL && (uint8_t*)ptr + old == block->data + block->used){
+		size_t offset = (uint8_t*)ptr - block->data;
+		size_t new = arena_align(size > 0 ? size : 1);
+		if(offset + new <= block->size){
+			block->used = offset + new;
+			a->allocated = a->allocated - old + new;
+			return ptr;
+		}
+	}
+
+	if(size <= oldSize) return ptr;
+
+	void *new = arena_alloc(a, size);
+	if(new != NULL)
+		memcpy(new, ptr, oldSize);
+
+	return new;
+}
+
+// !trivial
+char *arena_strndup(arena_t *a, const char *str, size_t len){
+	char *new = arena_alloc(a, len + 1);
+	memcpy(new, str, len);
+	new[len] = '\0';
+	return new;
+}
+
+arena_mark_t arena_mark(const arena_t *a){
+	return (arena_mark_t){
+		.block = a->block,
+		.used = a->block != NULL ? a->block->used : 0,
+		.allocated = a->allocated
+	};
+}
+
+// !trivial
+void arena_rewind(arena_t *a, arena_mark_t mark){
+	// free the blocks created after the mark, keeping at least one for reuse
+	while(a->block != NULL && a->block != mark.block && (mark.block != NULL || a->block->prev != NULL)){
+		arena_block_t *prev = a->block->prev;
+		free(a->block);
+		a->block = prev;
+	}
+
+	if(a->block != NULL)
+		a->block->used = mark.block != NULL ? mark.used : 0;
+
+	a->allocated = mark.allocated;
+}
+
+void arena_reset(arena_t *a){
+	arena_rewind(a, (arena_mark_t){0});
+}
+
+size_t arena_allocated(const arena_t *a){
+	return a->allocated;
+}
@@ -0,0 +1,118 @@
+#ifndef _ARENA_HEADER_
+#define _ARENA_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Bump allocator. Memory is handed out sequentially from big blocks and is only given back all at once,
+ * by 'arena_reset', 'arena_rewind' or 'arena_destroy', so a whole parse can be allocated and released in O(1).
+ * Strings, arrays, lists and matrices have '_arena' constructors that allocate from an arena,
+ * their destroy functions become no-ops and the memory goes away with the arena
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// default size of the blocks requested from malloc, allocations bigger than that get a block of their own
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+// alignment of every allocation
+#define ARENA_ALIGNMENT 16
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef struct arena_block_t arena_block_t;
+struct arena_block_t{
+	arena_block_t *prev;
+	size_t size;
+	size_t used;
+	_Alignas(ARENA_ALIGNMENT) uint8_t data[];
+};
+
+typedef struct{
+	arena_block_t *block;									/**< current block, older blocks are linked through 'prev' */
+	size_t blockSize;
+	size_t allocated;										/**< bytes handed out since the last reset */
+}arena_t;
+
+/**
+ * @brief a position in the arena, taken with 'arena_mark' and restored with 'arena_rewind'
+*/
+typedef struct{
+	arena_block_t *block;
+	size_t used;
+	size_t allocated;
+}arena_mark_t;
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief creates a new arena with blocks of 'ARENA_BLOCK_SIZE'. No memory is reserved until the first allocation
+*/
+arena_t *arena_new(void);
+
+/**
+ * @brief creates a new arena
+ * @param blockSize: size of the blocks requested from malloc
+*/
+arena_t *arena_new_custom(size_t blockSize);
+
+/**
+ * @brief frees the arena and everything allocated from it
+*/
+void arena_destroy(arena_t *a);
+
+/**
+ * @brief allocate 'size' bytes, aligned to 'ARENA_ALIGNMENT'. Memory is not initialized
+ * @attention O(1)
+*/
+void *arena_alloc(arena_t *a, size_t size);
+
+/**
+ * @brief allocate 'count' * 'size' zeroed bytes
+ * @attention O(n)
+*/
+void *arena_calloc(arena_t *a, size_t count, size_t size);
+
+/**
+ * @brief grow or shrink an allocation. When 'ptr' is the last allocation and fits it's block it's resized in place,
+ * otherwise a new allocation is made and 'oldSize' bytes are copied over. The old memory is only freed with the arena
+ * @param ptr: previous allocation or NULL
+ * @param oldSize: size of the previous allocation
+ * @param size: the new size
+*/
+void *arena_realloc(arena_t *a, void *ptr, size_t oldSize, size_t size);
+
+/**
+ * @brief copy 'len' chars of 'str' into the arena, null terminated
+*/
+char *arena_strndup(arena_t *a, const char *str, size_t len);
+
+/**
+ * @brief current position of the arena, to be restored with 'arena_rewind'
+*/
+arena_mark_t arena_mark(const arena_t *a);
+
+/**
+ * @brief free everything allocated after 'mark' was taken. Use it to scope temporary allocations:
+ * @details
+ * arena_mark_t mark = arena_mark(arena);
+ * string *tmp = string_new_arena(arena, 128);
+ * ...
+ * arena_rewind(arena, mark);
+*/
+void arena_rewind(arena_t *a, arena_mark_t mark);
+
+/**
+ * @brief free everything allocated from the arena. The first block is kept for reuse
+*/
+void arena_reset(arena_t *a);
+
+/**
+ * @brief bytes handed out since the last reset
+*/
+size_t arena_allocated(const arena_t *a);
+
+#endif
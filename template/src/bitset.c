@@ -0,0 +1,229 @@
+#include "bitset.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// ------------------------------------------------------------ Bitset -------------------------------------------------------------
+
+static inline size_t bitset_words(size_t size){
+	return (size + 63) >> 6;
+}
+
+// !trivial
+// bits past 'size' in the last word are kept clear, so whole words can be counted and compared
+static inline void bitset_mask_tail(bitset_t *b){
+	if(b->size & 63)
+		b->words[b->size >> 6] &= ((uint64_t)1 << (b->size & 63)) - 1;
+}
+
+// !trivial
+static void bitset_init(bitset_t *b, size_t size, bool growable){
+	b->size = size;
+	b->growable = growable;
+	b->capacity = bitset_words(size) > 0 ? bitset_words(size) : 1;
+	b->words = calloc(b->capacity, sizeof(uint64_t));
+}
+
+static bitset_t *bitset_new_raw(size_t size, bool growable){
+	bitset_t *b = malloc(sizeof(bitset_t));
+	bitset_init(b, size, growable);
+	return b;
+}
+
+bitset_t *bitset_new(size_t size){
+	return bitset_new_raw(size, false);
+}
+
+bitset_t *bitset_new_growable(size_t size){
+	return bitset_new_raw(size, true);
+}
+
+// !trivial
+bitset_t *bitset_copy(const bitset_t *b){
+	bitset_t *new = bitset_new_raw(b->size, b->growable);
+	memcpy(new->words, b->words, bitset_words(b->size) * sizeof(uint64_t));
+	return new;
+}
+
+void bitset_destroy(bitset_t *b){
+	if(b == NULL) return;
+	free(b->words);
+	free(b);
+}
+
+size_t bitset_size(const bitset_t *b){
+	return b->size;
+}
+
+// !trivial
+void bitset_resize(bitset_t *b, size_t size){
+	size_t words = bitset_words(size);
+	if(words > b->capacity){
+		size_t capacity = b->capacity * 2 > words ? b->capacity * 2 : words;
+		b->words = realloc(b->words, capacity * sizeof(uint64_t));
+		memset(b->words + b->capacity, 0, (capacity - b->capacity) * sizeof(uint64_t));
+		b->capacity = capacity;
+	}
+
+	// shrinking, clear what was cut so growing again gives clear bits
+	if(size < b->size){
+		size_t old = bitset_words(b->size);
+		b->size = size;
+		bitset_mask_tail(b);
+		memset(b->words + words, 0, (old - words) * sizeof(uint64_t));
+	}
+
+	b->size = size;
+}
+
+void bitset_clear_all(bitset_t *b){
+	memset(b->words, 0, bitset_words(b->size) * sizeof(uint64_t));
+}
+
+void bitset_set_all(bitset_t *b){
+	memset(b->words, 0xFF, bitset_words(b->size) * sizeof(uint64_t));
+	bitset_mask_tail(b);
+}
+
+// !trivial
+size_t bitset_count(const bitset_t *b){
+	size_t words = bitset_words(b->size);
+	size_t count = 0;
+	size_t i = 0;
+
+#ifdef __SSE2__
+	// bit twiddling popcount on 128 bits, the byte counts are summed by 'psadbw'
+	const __m128i m1 = _mm_set1_epi8(0x55);
+	const __m128i m2 = _mm_set1_epi8(0x33);
+	const __m128i m4 = _mm_set1_epi8(0x0F);
+	__m128i total = _mm_setzero_si128();
+	for(; i + 2 <= words; i += 2){
+		__m128i v = _mm_loadu_si128((const __m128i*)(b->words + i));
+		v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+		v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+		v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+		total = _mm_add_epi64(total, _mm_sad_epu8(v, _mm_setzero_si128()));
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i*)lanes, total);
+	count = lanes[0] + lanes[1];
+#endif
+
+	for(; i < words; i++)
+		count += __builtin_popcountll(b->words[i]);
+
+	return count;
+}
+
+// !trivial
+size_t bitset_next_set(const bitset_t *b, size_t from){
+	if(from >= b->size) return SIZE_MAX;
+
+	size_t words = bitset_words(b->size);
+	size_t i = from >> 6;
+	uint64_t word = b->words[i] & (~(uint64_t)0 << (from & 63));
+	while(word == 0){
+		if(++i >= words) return SIZE_MAX;
+		word = b->words[i];
+	}
+
+	return (i << 6) + __builtin_ctzll(word);
+}
+
+// !trivial
+// apply an operation to 'count' words of 'dest' and 'src', two words at a time with SSE2
+#ifdef __SSE2__
+#define BITSET_APPLY(dest, src, count, sseOp, op)															\
+	{																										\
+		size_t i = 0;																						\
+		for(; i + 2 <= (count); i += 2){																	\
+			__m128i d = _mm_loadu_si128((const __m128i*)((dest) + i));										\
+			__m128i s = _mm_loadu_si128((const __m128i*)((src) + i));										\
+			_mm_storeu_si128((__m128i*)((dest) + i), sseOp);												\
+		}																									\
+		for(; i < (count); i++){																			\
+			uint64_t d = (dest)[i];																			\
+			uint64_t s = (src)[i];																			\
+			(dest)[i] = op;																					\
+		}																									\
+	}
+#else
+#define BITSET_APPLY(dest, src, count, sseOp, op)															\
+	for(size_t i = 0; i < (count); i++){																	\
+		uint64_t d = (dest)[i];																				\
+		uint64_t s = (src)[i];																				\
+		(dest)[i] = op;																						\
+	}
+#endif
+
+static inline size_t bitset_min(size_t a, size_t b){
+	return a < b ? a : b;
+}
+
+// !trivial
+void bitset_and(bitset_t *dest, const bitset_t *src){
+	size_t words = bitset_words(dest->size);
+	size_t common = bitset_min(words, bitset_words(src->size));
+	BITSET_APPLY(dest->words, src->words, common, _mm_and_si128(d, s), d & s);
+	memset(dest->words + common, 0, (words - common) * sizeof(uint64_t));
+}
+
+// !trivial
+void bitset_or(bitset_t *dest, const bitset_t *src){
+	if(dest->growable && src->size > dest->size)
+		bitset_resize(dest, src->size);
+
+	size_t common = bitset_min(bitset_words(dest->size), bitset_words(src->size));
+	BITSET_APPLY(dest->words, src->words, common, _mm_or_si128(d, s), d | s);
+	bitset_mask_tail(dest);
+}
+
+// !trivial
+void bitset_xor(bitset_t *dest, const bitset_t *src){
+	if(dest->growable && src->size > dest->size)
+		bitset_resize(dest, src->size);
+
+	size_t common = bitset_min(bitset_words(dest->size), bitset_words(src->size));
+	BITSET_APPLY(dest->words, src->words, common, _mm_xor_si128(d, s), d ^ s);
+	bitset_mask_tail(dest);
+}
+
+// !trivial
+void bitset_andnot(bitset_t *dest, const bitset_t *src){
+	size_t common = bitset_min(bitset_words(dest->size), bitset_words(src->size));
+	BITSET_APPLY(dest->words, src->words, common, _mm_andnot_si128(s, d), d & ~s);
+}
+
+#undef BITSET_APPLY
+
+// !trivial
+bool bitset_equal(const bitset_t *a, const bitset_t *b){
+	return a->size == b->size && !memcmp(a->words, b->words, bitset_words(a->size) * sizeof(uint64_t));
+}
+
+// ------------------------------------------------------------ Bitmap -------------------------------------------------------------
+
+// !trivial
+bitmap_t *bitmap_new(size_t w, size_t h){
+	bitmap_t *bm = malloc(sizeof(bitmap_t));
+	bm->w = w;
+	bm->h = h;
+	bitset_init(&bm->bits, w * h, false);
+	return bm;
+}
+
+bitmap_t *bitmap_new_matrix(const matrix_t *m){
+	return bitmap_new(m->w, m->h);
+}
+
+void bitmap_destroy(bitmap_t *bm){
+	if(bm == NULL) return;
+	free(bm->bits.words);
+	free(bm);
+}
+
+size_t bitmap_count(const bitmap_t *bm){
+	return bitset_count(&bm->bits);
+}
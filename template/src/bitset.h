@@ -0,0 +1,202 @@
+#ifndef _BITSET_HEADER_
+#define _BITSET_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "matrix.h"
+
+/**
+ * @file Dense sets of bits, one bit per element. Use them as visited sets instead of hashtables of coordinates
+ * or matrices of sentinel values. Set operations work on whole words, 128 bits at a time with SSE2.
+ * Single bit functions are static inline, they are the hot path of searches
+*/
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef struct{
+	uint64_t *words;
+	size_t size;											/**< number of bits */
+	size_t capacity;										/**< number of words */
+	bool growable;											/**< setting a bit past 'size' grows the set instead of being ignored */
+}bitset_t;
+
+/**
+ * @brief 2D set of bits, bit 'y * w + x' is the cell (y, x), the same index as 'matrix_index_point'
+*/
+typedef struct{
+	bitset_t bits;
+	size_t w;
+	size_t h;
+}bitmap_t;
+
+// ------------------------------------------------------------ Bitset -------------------------------------------------------------
+
+/**
+ * @brief creates a bitset of 'size' bits, all clear. Bits past 'size' are ignored
+*/
+bitset_t *bitset_new(size_t size);
+
+/**
+ * @brief creates a bitset of 'size' bits, all clear. Setting a bit past 'size' grows it
+*/
+bitset_t *bitset_new_growable(size_t size);
+
+bitset_t *bitset_copy(const bitset_t *b);
+
+void bitset_destroy(bitset_t *b);
+
+/**
+ * @brief number of bits
+*/
+size_t bitset_size(const bitset_t *b);
+
+/**
+ * @brief change the number of bits, new bits are clear
+*/
+void bitset_resize(bitset_t *b, size_t size);
+
+static inline bool bitset_test(const bitset_t *b, size_t i){
+	return i < b->size && (b->words[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void bitset_set(bitset_t *b, size_t i){
+	if(i >= b->size){
+		if(!b->growable) return;
+		bitset_resize(b, i + 1);
+	}
+	b->words[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+static inline void bitset_clear(bitset_t *b, size_t i){
+	if(i < b->size)
+		b->words[i >> 6] &= ~((uint64_t)1 << (i & 63));
+}
+
+/**
+ * @brief set a bit and return it's previous value, to mark and check a visited element at once
+*/
+static inline bool bitset_test_and_set(bitset_t *b, size_t i){
+	bool was = bitset_test(b, i);
+	bitset_set(b, i);
+	return was;
+}
+
+/**
+ * @brief clear all bits
+ * @attention O(n / 64)
+*/
+void bitset_clear_all(bitset_t *b);
+
+/**
+ * @brief set all bits
+ * @attention O(n / 64)
+*/
+void bitset_set_all(bitset_t *b);
+
+/**
+ * @brief number of set bits
+ * @attention O(n / 64)
+*/
+size_t bitset_count(const bitset_t *b);
+
+/**
+ * @brief position of the first set bit at or after 'from', SIZE_MAX if none. Iterate with:
+ * for(size_t i = bitset_next_set(b, 0); i != SIZE_MAX; i = bitset_next_set(b, i + 1))
+*/
+size_t bitset_next_set(const bitset_t *b, size_t from);
+
+/**
+ * @brief 'dest' = 'dest' & 'src'. Bits of 'dest' past the end of 'src' are cleared
+ * @attention O(n / 64)
+*/
+void bitset_and(bitset_t *dest, const bitset_t *src);
+
+/**
+ * @brief 'dest' = 'dest' | 'src'. A growable 'dest' grows to the size of 'src', otherwise the bits past it's end are ignored
+ * @attention O(n / 64)
+*/
+void bitset_or(bitset_t *dest, const bitset_t *src);
+
+/**
+ * @brief 'dest' = 'dest' ^ 'src', growing like 'bitset_or'
+ * @attention O(n / 64)
+*/
+void bitset_xor(bitset_t *dest, const bitset_t *src);
+
+/**
+ * @brief 'dest' = 'dest' & ~'src'
+ * @attention O(n / 64)
+*/
+void bitset_andnot(bitset_t *dest, const bitset_t *src);
+
+/**
+ * @brief true if both have the same size and bits
+*/
+bool bitset_equal(const bitset_t *a, const bitset_t *b);
+
+// ------------------------------------------------------------ Bitmap -------------------------------------------------------------
+
+/**
+ * @brief creates a 'w' by 'h' bitmap, all clear
+*/
+bitmap_t *bitmap_new(size_t w, size_t h);
+
+/**
+ * @brief creates a bitmap with the same dimensions of a matrix, all clear
+*/
+bitmap_t *bitmap_new_matrix(const matrix_t *m);
+
+void bitmap_destroy(bitmap_t *bm);
+
+static inline bool bitmap_inside(const bitmap_t *bm, size_t y, size_t x){
+	return y < bm->h && x < bm->w;
+}
+
+/**
+ * @brief cells outside the bitmap are never set
+*/
+static inline bool bitmap_test(const bitmap_t *bm, size_t y, size_t x){
+	return bitmap_inside(bm, y, x) && bitset_test(&bm->bits, y * bm->w + x);
+}
+
+/**
+ * @brief cells outside the bitmap are ignored
+*/
+static inline void bitmap_set(bitmap_t *bm, size_t y, size_t x){
+	if(bitmap_inside(bm, y, x))
+		bitset_set(&bm->bits, y * bm->w + x);
+}
+
+static inline void bitmap_clear(bitmap_t *bm, size_t y, size_t x){
+	if(bitmap_inside(bm, y, x))
+		bitset_clear(&bm->bits, y * bm->w + x);
+}
+
+/**
+ * @brief set a cell and return it's previous value. Cells outside the bitmap return true, as if already visited
+*/
+static inline bool bitmap_test_and_set(bitmap_t *bm, size_t y, size_t x){
+	if(!bitmap_inside(bm, y, x)) return true;
+	return bitset_test_and_set(&bm->bits, y * bm->w + x);
+}
+
+static inline bool bitmap_ptest(const bitmap_t *bm, point_t p){
+	return bitmap_test(bm, p.y, p.x);
+}
+
+static inline void bitmap_pset(bitmap_t *bm, point_t p){
+	bitmap_set(bm, p.y, p.x);
+}
+
+static inline bool bitmap_ptest_and_set(bitmap_t *bm, point_t p){
+	return bitmap_test_and_set(bm, p.y, p.x);
+}
+
+/**
+ * @brief number of set cells
+*/
+size_t bitmap_count(const bitmap_t *bm);
+
+#endif
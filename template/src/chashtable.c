@@ -0,0 +1,117 @@
+#include "chashtable.h"
+#include "hash.h"
+
+// ------------------------------------------------------------ Concurrent hash table ----------------------------------------------
+
+// !trivial
+chashtable_t *chashtable_new(size_t shards, bool takeOwnership){
+	chashtable_t *h = calloc(1, sizeof(chashtable_t));
+	h->onws = takeOwnership;
+
+	h->count = 1;
+	while(h->count < (shards > 0 ? shards : CHASHTABLE_SHARDS))
+		h->count <<= 1;
+
+	h->shards = aligned_alloc(_Alignof(chashtable_shard_t), h->count * sizeof(chashtable_shard_t));
+	for(size_t i = 0; i < h->count; i++){
+		pthread_rwlock_init(&h->shards[i].lock, NULL);
+		h->shards[i].h = hashtable_new_custom(0, takeOwnership, NULL);
+	}
+
+	return h;
+}
+
+// !trivial
+void chashtable_destroy(chashtable_t *h){
+	if(h == NULL) return;
+
+	for(size_t i = 0; i < h->count; i++){
+		pthread_rwlock_destroy(&h->shards[i].lock);
+		hashtable_destroy(h->shards[i].h);
+	}
+
+	free(h->shards);
+	free(h);
+}
+
+// !trivial
+size_t chashtable_size(chashtable_t *h){
+	size_t size = 0;
+	for(size_t i = 0; i < h->count; i++){
+		pthread_rwlock_rdlock(&h->shards[i].lock);
+		size += hashtable_size(h->shards[i].h);
+		pthread_rwlock_unlock(&h->shards[i].lock);
+	}
+
+	return size;
+}
+
+// !trivial
+// the shard tables index with the low bits of the same hash, pick the shard with the high ones
+static inline chashtable_shard_t *chashtable_shard(const chashtable_t *h, void *key, size_t keySize){
+	uint64_t hash = mix_hash(key, keySize);
+	return &h->shards[(hash >> 32) & (h->count - 1)];
+}
+
+// !trivial
+void *chashtable_get_bin(chashtable_t *h, void *key, size_t keySize){
+	chashtable_shard_t *shard = chashtable_shard(h, key, keySize);
+	pthread_rwlock_rdlock(&shard->lock);
+	void *value = hashtable_get_bin(shard->h, key, keySize);
+	pthread_rwlock_unlock(&shard->lock);
+	return value;
+}
+
+// !trivial
+bool chashtable_exists_bin(chashtable_t *h, void *key, size_t keySize){
+	chashtable_shard_t *shard = chashtable_shard(h, key, keySize);
+	pthread_rwlock_rdlock(&shard->lock);
+	bool exists = hashtable_exists_bin(shard->h, key, keySize);
+	pthread_rwlock_unlock(&shard->lock);
+	return exists;
+}
+
+// !trivial
+// 'release' frees 'value' if another one is already in, NULL to keep it
+static void *chashtable_set_shard(chashtable_shard_t *shard, void *key, size_t keySize, void *value, chashtable_free_func_t release){
+	pthread_rwlock_wrlock(&shard->lock);
+	bool exists = hashtable_exists_bin(shard->h, key, keySize);
+	void *current = exists ? hashtable_get_bin(shard->h, key, keySize) : value;
+	if(!exists)
+		hashtable_set_bin(shard->h, key, keySize, value);
+	pthread_rwlock_unlock(&shard->lock);
+
+	// lost the race, the table keeps the first value
+	if(exists && release != NULL && value != current)
+		release(value);
+
+	return current;
+}
+
+void *chashtable_set_bin(chashtable_t *h, void *key, size_t keySize, void *value){
+	return chashtable_set_shard(chashtable_shard(h, key, keySize), key, keySize, value, h->onws ? free : NULL);
+}
+
+// !trivial
+void *chashtable_remove_bin(chashtable_t *h, void *key, size_t keySize){
+	chashtable_shard_t *shard = chashtable_shard(h, key, keySize);
+	pthread_rwlock_wrlock(&shard->lock);
+	void *value = hashtable_remove_bin(shard->h, key, keySize);
+	pthread_rwlock_unlock(&shard->lock);
+	return value;
+}
+
+// !trivial
+void *chashtable_get_or_compute(chashtable_t *h, void *key, size_t keySize, chashtable_compute_func_t compute, chashtable_free_func_t release, void *context){
+	chashtable_shard_t *shard = chashtable_shard(h, key, keySize);
+
+	pthread_rwlock_rdlock(&shard->lock);
+	bool exists = hashtable_exists_bin(shard->h, key, keySize);
+	void *value = exists ? hashtable_get_bin(shard->h, key, keySize) : NULL;
+	pthread_rwlock_unlock(&shard->lock);
+	if(exists) return value;
+
+	// computed unlocked, it may recurse into the table
+	value = compute(key, keySize, context);
+	return chashtable_set_shard(shard, key, keySize, value, h->onws ? free : release);
+}
@@ -0,0 +1,111 @@
+#ifndef _CHASHTABLE_HEADER_
+#define _CHASHTABLE_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "data.h"
+
+/**
+ * @file Hashtable that can be shared by worker threads. Keys are spread over shards, each one a 'hashtable_t'
+ * behind it's own read write lock, so threads only wait on each other when they touch the same shard.
+ * Use it as a memo table or a visited set for parallel searches. Don't forget to link against '-lpthread'
+ * @details
+ * void *solve(const void *key, size_t keySize, void *context){
+ * 	 ...
+ * 	 void *sub = chashtable_get_or_compute(memo, &subKey, sizeof(subKey), solve, NULL, context);
+ * 	 ...
+ * }
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// default number of shards, a power of two well above the number of threads keeps contention low
+#define CHASHTABLE_SHARDS 64
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+/**
+ * @brief computes the value of a missing key for 'chashtable_get_or_compute'
+ * @param context: the context given to 'chashtable_get_or_compute'
+*/
+typedef void *(*chashtable_compute_func_t)(const void *key, size_t keySize, void *context);
+
+/**
+ * @brief frees a computed value that lost an insertion race in 'chashtable_get_or_compute'
+*/
+typedef void (*chashtable_free_func_t)(void *value);
+
+/**
+ * @brief a lock and the table it guards, on a cache line of it's own so shards don't share one
+*/
+typedef struct{
+	_Alignas(64) pthread_rwlock_t lock;
+	hashtable_t *h;
+}chashtable_shard_t;
+
+typedef struct{
+	chashtable_shard_t *shards;
+	size_t count;											/**< number of shards, a power of two */
+	bool onws;
+}chashtable_t;
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief creates a new concurrent hashtable
+ * @param shards: number of shards, rounded up to a power of two. Pass 0 for 'CHASHTABLE_SHARDS'
+ * @param takeOwnership: true if inserted values should be freed along with the hashtable deallocation,
+ * and values that lose an insertion race are freed right away
+*/
+chashtable_t *chashtable_new(size_t shards, bool takeOwnership);
+
+/**
+ * @brief destroys the hashtable, no other thread may be using it
+*/
+void chashtable_destroy(chashtable_t *h);
+
+/**
+ * @brief number of keys. Other threads may change it at the same time, so it's only exact when they don't
+ * @attention O(shards)
+*/
+size_t chashtable_size(chashtable_t *h);
+
+/**
+ * @brief get a value using a binary value 'key' of size 'keySize'
+ * @return NULL if not found
+ * @attention Avg: O(1), takes the shard lock for reading
+*/
+void *chashtable_get_bin(chashtable_t *h, void *key, size_t keySize);
+
+/**
+ * @brief insert a value if the key is not in yet
+ * @return the value in the table afterwards: 'value' if it was inserted, the value already there otherwise
+ * @attention Avg: O(1), takes the shard lock for writing
+*/
+void *chashtable_set_bin(chashtable_t *h, void *key, size_t keySize, void *value);
+
+/**
+ * @brief removes and returns a value, NULL if not found
+ * @attention Avg: O(1), takes the shard lock for writing
+*/
+void *chashtable_remove_bin(chashtable_t *h, void *key, size_t keySize);
+
+/**
+ * @brief check if a key is in
+ * @attention Avg: O(1), takes the shard lock for reading
+*/
+bool chashtable_exists_bin(chashtable_t *h, void *key, size_t keySize);
+
+/**
+ * @brief get the value of 'key', computing and inserting it when missing.
+ * 'compute' runs without any lock held, so it can call back into the table, for memoized recursion.
+ * Two threads missing the same key at the same time may both compute it, the first insert wins and both get that value
+ * @param release: frees the values that lose the race when the table doesn't own them.
+ * Pass NULL if they don't need freeing, like integers cast to pointers. Owning tables always use 'free'
+ * @return the value in the table
+*/
+void *chashtable_get_or_compute(chashtable_t *h, void *key, size_t keySize, chashtable_compute_func_t compute, chashtable_free_func_t release, void *context);
+
+#endif
@@ -0,0 +1,86 @@
+#include "counter.h"
+
+// ------------------------------------------------------------ Hash set -----------------------------------------------------------
+
+// !trivial
+void hashset_merge(hashset_t *dest, const hashset_t *src){
+	for(size_t i = 0; i < src->capacity; i++){
+		if(src->ctrl[i] != HASHMAP_CTRL_EMPTY)
+			hashset_add(dest, src->entries[i].key);
+	}
+}
+
+// ------------------------------------------------------------ Counter ------------------------------------------------------------
+
+// !trivial
+int64_t counter_total(const counter_t *c){
+	int64_t total = 0;
+	for(size_t i = 0; i < c->capacity; i++){
+		if(c->ctrl[i] != HASHMAP_CTRL_EMPTY)
+			total += c->entries[i].value;
+	}
+	return total;
+}
+
+// !trivial
+void counter_merge(counter_t *dest, const counter_t *src, int64_t scale){
+	for(size_t i = 0; i < src->capacity; i++){
+		if(src->ctrl[i] != HASHMAP_CTRL_EMPTY)
+			counter_add(dest, src->entries[i].key, src->entries[i].value * scale);
+	}
+}
+
+// !trivial
+// restore the min heap on the count of 'heap' from 'pos' down
+static void counter_heap_down(counter_entry_t *heap, size_t size, size_t pos){
+	counter_entry_t entry = heap[pos];
+	for(;;){
+		size_t child = pos * 2 + 1;
+		if(child >= size) break;
+		if(child + 1 < size && heap[child + 1].value < heap[child].value)
+			child++;
+		if(heap[child].value >= entry.value) break;
+
+		heap[pos] = heap[child];
+		pos = child;
+	}
+	heap[pos] = entry;
+}
+
+// !trivial
+size_t counter_top(const counter_t *c, size_t k, counter_entry_t *out){
+	if(k == 0) return 0;
+
+	// keep the best 'k' in a min heap, the smallest of them on top
+	size_t size = 0;
+	for(size_t i = 0; i < c->capacity; i++){
+		if(c->ctrl[i] == HASHMAP_CTRL_EMPTY) continue;
+
+		if(size < k){
+			out[size++] = c->entries[i];
+			if(size == k){
+				for(size_t j = k / 2; j-- > 0;)
+					counter_heap_down(out, size, j);
+			}
+		}
+		else if(c->entries[i].value > out[0].value){
+			out[0] = c->entries[i];
+			counter_heap_down(out, size, 0);
+		}
+	}
+
+	if(size < k){
+		for(size_t j = size / 2; j-- > 0;)
+			counter_heap_down(out, size, j);
+	}
+
+	// pop the smallest to the back, leaving them highest first
+	for(size_t n = size; n > 1; n--){
+		counter_entry_t smallest = out[0];
+		out[0] = out[n - 1];
+		out[n - 1] = smallest;
+		counter_heap_down(out, n - 1, 0);
+	}
+
+	return size;
+}
@@ -0,0 +1,84 @@
+#ifndef _COUNTER_HEADER_
+#define _COUNTER_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hashmap.h"
+
+/**
+ * @file Sets and counters (multisets) of integer keys, on the open addressing tables of hashmap.h.
+ * Counts are stored inline next to their keys, so iterating a counter is a scan of one array.
+ * @details
+ * counter_t *stones = counter_new(0);
+ * counter_add(stones, 125, 1);
+ * counter_ite ite = counter_iterate(stones);
+ * for(counter_entry_t *e = next(ite); yield(ite); e = next(ite))
+ * 	 counter_add(blink, e->key * 2024, e->value);
+*/
+
+// ------------------------------------------------------------ Hash set -----------------------------------------------------------
+
+/**
+ * @brief 'hashset_t', a set of uint64_t. See 'HASHSET_DEFINE' for the generated functions:
+ * hashset_new, hashset_destroy, hashset_clear, hashset_size, hashset_add, hashset_exists, hashset_remove, hashset_iterate
+*/
+HASHSET_DEFINE(hashset, uint64_t, hashmap_hash_u64, hashmap_eq_scalar)
+
+/**
+ * @brief add every key of 'src' to 'dest'
+ * @attention O(n)
+*/
+void hashset_merge(hashset_t *dest, const hashset_t *src);
+
+// ------------------------------------------------------------ Counter ------------------------------------------------------------
+
+/**
+ * @brief 'counter_t', a map of uint64_t keys to int64_t counts. See 'HASHMAP_DEFINE' for the generated functions:
+ * counter_new, counter_destroy, counter_clear, counter_size, counter_get, counter_exists, counter_put, counter_set,
+ * counter_remove, counter_iterate
+*/
+HASHMAP_DEFINE(counter, uint64_t, int64_t, hashmap_hash_u64, hashmap_eq_scalar)
+
+/**
+ * @brief add 'delta' to the count of 'key', keys whose count drops to 0 are removed
+ * @return the new count
+ * @attention Avg: O(1)
+*/
+static inline int64_t counter_add(counter_t *c, uint64_t key, int64_t delta){
+	int64_t *count = counter_put(c, key, NULL);
+	int64_t value = *count += delta;
+	if(value == 0)
+		counter_remove(c, key, NULL);
+	return value;
+}
+
+/**
+ * @brief count of 'key', 0 if it's not in
+*/
+static inline int64_t counter_count(const counter_t *c, uint64_t key){
+	int64_t *count = counter_get(c, key);
+	return count != NULL ? *count : 0;
+}
+
+/**
+ * @brief sum of all counts
+ * @attention O(n)
+*/
+int64_t counter_total(const counter_t *c);
+
+/**
+ * @brief add the counts of 'src', multiplied by 'scale', to 'dest'
+ * @attention O(n)
+*/
+void counter_merge(counter_t *dest, const counter_t *src, int64_t scale);
+
+/**
+ * @brief the 'k' keys with the highest counts, highest first
+ * @param out: room for 'k' entries
+ * @return number of entries written, less than 'k' if the counter is smaller
+ * @attention O(n log k)
+*/
+size_t counter_top(const counter_t *c, size_t k, counter_entry_t *out);
+
+#endif
@@ -2,6 +2,101 @@
 #include "hash.h"
 #include "ite.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static node_t *list_node_new(list_t *l, void *value){
+	node_t *new;
+	if(l->pool != NULL)
+		new = pool_calloc(l->pool);
+	else if(l->arena != NULL)
+		new = arena_calloc(l->arena, 1, sizeof(node_t));
+	else
+		new = calloc(1, sizeof(node_t));
+
+	new->value = value;
+	return new;
+}
+
+static void list_node_free(list_t *l, node_t *node){
+	if(l->pool != NULL)
+		pool_free(l->pool, node);
+	else if(l->arena == NULL)
+		free(node);
+}
+
+// ------------------------------------------------------------ List index ---------------------------------------------------------
+
+static list_index_slot_t *list_index_alloc(size_t capacity){
+	return calloc(capacity, sizeof(list_index_slot_t));
+}
+
+// !trivial
+// slot of the node with a value equal to 'value', or the free slot ending it's probe sequence
+static size_t list_index_find(const list_index_t *index, const void *value, uint64_t hash){
+	size_t mask = index->capacity - 1;
+	for(size_t i = hash & mask;; i = (i + 1) & mask){
+		const list_index_slot_t *s = &index->slots[i];
+		if(s->node == NULL || (s->hash == hash && index->eq(s->node->value, value))) return i;
+	}
+}
+
+// !trivial
+static void list_index_place(list_index_t *index, node_t *node, uint64_t hash){
+	size_t mask = index->capacity - 1;
+	size_t i = hash & mask;
+	while(index->slots[i].node != NULL)
+		i = (i + 1) & mask;
+
+	index->slots[i] = (list_index_slot_t){.hash = hash, .node = node};
+	index->count++;
+}
+
+// !trivial
+static void list_index_add(list_index_t *index, node_t *node, uint64_t hash){
+	if((index->count + 1) * 4 > index->capacity * 3){
+		list_index_slot_t *old = index->slots;
+		size_t oldCapacity = index->capacity;
+		index->capacity <<= 1;
+		index->slots = list_index_alloc(index->capacity);
+		index->count = 0;
+		for(size_t i = 0; i < oldCapacity; i++)
+			if(old[i].node != NULL)
+				list_index_place(index, old[i].node, old[i].hash);
+		free(old);
+	}
+
+	list_index_place(index, node, hash);
+}
+
+// !trivial
+// backward shift: pull back the following slots that can't be reached with the node's slot free
+static void list_index_remove(list_index_t *index, const node_t *node){
+	size_t mask = index->capacity - 1;
+	size_t i = index->hash(node->value) & mask;
+	while(index->slots[i].node != node){
+		if(index->slots[i].node == NULL) return;
+		i = (i + 1) & mask;
+	}
+
+	for(size_t j = (i + 1) & mask; index->slots[j].node != NULL; j = (j + 1) & mask){
+		size_t home = index->slots[j].hash & mask;
+		if(((j - home) & mask) < ((j - i) & mask)) continue;
+		index->slots[i] = index->slots[j];
+		i = j;
+	}
+
+	index->slots[i].node = NULL;
+	index->count--;
+}
+
+static void list_index_destroy(list_index_t *index){
+	if(index == NULL) return;
+	free(index->slots);
+	free(index);
+}
+
 node_t *node_clone(const node_t *node){
 	node_t *new = calloc(1, sizeof(node_t));
 	new->value = node->value;
@@ -41,8 +136,52 @@ list_t *list_new_custom_stack(bool takeOwnership, cmpFunc priorityCmp){
 	return l;
 }
 
+list_t *list_new_arena(arena_t *arena, list_type_t type, cmpFunc priorityCmp){
+	list_t *l = arena_calloc(arena, 1, sizeof(list_t));
+	l->type = type;
+	l->cmpFunc = priorityCmp;
+	l->arena = arena;
+	return l;
+}
+
+// !trivial
+list_t *list_new_pooled(list_type_t type, bool takeOwnership, cmpFunc priorityCmp, pool_t *pool){
+	list_t *l = list_new();
+	l->type = type;
+	l->onws = takeOwnership;
+	l->cmpFunc = priorityCmp;
+	l->poolOwned = pool == NULL;
+	l->pool = pool != NULL ? pool : pool_new(sizeof(node_t));
+	return l;
+}
+
+// !trivial
+bool list_set_unique(list_t *l, valueHashFunc hash, valueEqFunc eq){
+	if(l->arena != NULL) return false;
+
+	list_index_destroy(l->index);
+	l->index = malloc(sizeof(list_index_t));
+	l->index->capacity = LIST_INDEX_MIN_CAPACITY;
+	while(l->index->capacity * 3 < l->size * 4)
+		l->index->capacity <<= 1;
+	l->index->slots = list_index_alloc(l->index->capacity);
+	l->index->count = 0;
+	l->index->hash = hash;
+	l->index->eq = eq;
+
+	for(node_t *n = l->first; n != NULL; n = n->next)
+		list_index_add(l->index, n, hash(n->value));
+
+	return true;
+}
+
 // !trivial
 void list_destroy(list_t *l){
+	// nodes and list are released with the arena
+	if(l->arena != NULL) return;
+
+	list_index_destroy(l->index);
+
 	if(l->size > 0){
 		node_t *cursor = l->first;
 		node_t *t;
@@ -52,17 +191,29 @@ void list_destroy(list_t *l){
 			if(l->onws)
 				free(cursor->value);
 			
-			free(cursor);
+			// a pool of it's own goes away at once
+			if(!l->poolOwned)
+				list_node_free(l, cursor);
 			cursor = t;
 		}
 	}
 
+	if(l->poolOwned)
+		pool_destroy(l->pool);
+
 	free(l);
 }
 
 // !trivial
 node_t *list_push(list_t *l, void *value){
 	node_t *new;
+	uint64_t hash = 0;
+	if(l->index != NULL){
+		hash = l->index->hash(value);
+		if(l->index->slots[list_index_find(l->index, value, hash)].node != NULL)
+			return NULL;
+	}
+
 	if(l->size > 0){
 		node_t *cursor = l->last;
 
@@ -88,8 +239,7 @@ node_t *list_push(list_t *l, void *value){
 		// insert node
 		insert:
 		{
-			new = calloc(1, sizeof(node_t));
-			new->value = value;
+			new = list_node_new(l, value);
 			
 			// insert as first
 			if(cursor == NULL){
@@ -113,19 +263,22 @@ node_t *list_push(list_t *l, void *value){
 		}
 	}
 	else{
-		new = calloc(1, sizeof(node_t));
-		new->value = value;
+		new = list_node_new(l, value);
 		l->first = new;
 		l->last = new;
 	}
 
+	if(l->index != NULL)
+		list_index_add(l->index, new, hash);
+
 	l->size++;
 	return new;
 }
 
 // !trivial
 void list_merge(list_t *dest, list_t *consumed){
-	if(consumed == NULL || consumed->first == NULL || dest->onws != consumed->onws) return;
+	if(consumed == NULL || consumed->first == NULL || dest->onws != consumed->onws || dest->arena != consumed->arena || dest->pool != consumed->pool) return;
+	if(dest->index != NULL || consumed->index != NULL) return;
 	if(dest->size == 0){
 		dest->first = consumed->first;
 		dest->last = consumed->last;
@@ -137,11 +290,19 @@ void list_merge(list_t *dest, list_t *consumed){
 	}
 
 	dest->size += consumed->size;
+
+	// the nodes belong to 'dest' now
+	consumed->first = NULL;
+	consumed->last = NULL;
+	consumed->size = 0;
 	list_destroy(consumed);
 }
 
 // !trivial
 void *list_remove_node(list_t *l, node_t *node){
+	if(l->index != NULL)
+		list_index_remove(l->index, node);
+
 	if(node->prev != NULL)
 		node->prev->next = node->next;
 	else
@@ -154,7 +315,7 @@ void *list_remove_node(list_t *l, node_t *node){
 
 	l->size--;
 	void *v = node->value;
-	free(node);
+	list_node_free(l, node);
 	return v;
 }
 
@@ -173,6 +334,9 @@ void *list_pop(list_t *l){
 
 // !trivial
 bool list_exists(const list_t *l, void *value){
+	if(l->index != NULL)
+		return l->index->slots[list_index_find(l->index, value, l->index->hash(value))].node != NULL;
+
 	if(l->cmpFunc == NULL) return true;
 	list_ite ite = list_iterate(l);
 	foreach(void*, v, ite){
@@ -259,8 +423,21 @@ array_t *array_new(void){
 	return array_new_custom(false, MIN_ARRAY_BLOCK_SIZE);
 }
 
+// !trivial
+array_t *array_new_arena(arena_t *arena, size_t blockSize){
+	array_t *a = arena_calloc(arena, 1, sizeof(array_t));
+	a->arena = arena;
+	a->allocated = blockSize;
+	a->blockSize = blockSize;
+	a->raw = arena_calloc(arena, a->allocated, sizeof(void*));
+	return a;
+}
+
 // !trivial
 void array_destroy(array_t *a){
+	// storage is released with the arena
+	if(a->arena != NULL) return;
+
 	if(a->onws){
 		for(size_t i = 0; i < a->size; i++){
 			free(a->raw[i]);	
@@ -282,7 +459,14 @@ bool array_set_raw(array_t *a, size_t pos, void *value){
 	if(pos >= a->allocated){
 		size_t prev = a->allocated;
 		a->allocated = pos + a->blockSize;
-		a->raw = realloc(a->raw, a->allocated * sizeof(void*));
+		if(a->arena != NULL){
+			// the old storage is only released with the arena, so grow geometrically
+			if(a->allocated < prev * 2)
+				a->allocated = prev * 2;
+			a->raw = arena_realloc(a->arena, a->raw, prev * sizeof(void*), a->allocated * sizeof(void*));
+		}
+		else
+			a->raw = realloc(a->raw, a->allocated * sizeof(void*));
 		memset(a->raw + prev, 0, (a->allocated - prev) * sizeof(void*));
 	}
 
@@ -313,13 +497,10 @@ void *array_get_raw(array_t *a, size_t pos, bool remove, bool rearrange){
 	if(remove){
 		a->raw[pos] = NULL;
 
-		if(rearrange && a->size > 0){
+		if(rearrange && pos < a->size){
 			a->size -= 1;
-			size_t i = pos;
-			while(i < a->size){
-				a->raw[i] = a->raw[i+1];
-				i++;
-			}
+			memmove(a->raw + pos, a->raw + pos + 1, (a->size - pos) * sizeof(void*));
+			a->raw[a->size] = NULL;
 		}
 	} 
 
@@ -344,82 +525,244 @@ size_t array_size(const array_t *a){
 
 // ------------------------------------------------------------ Hash table ---------------------------------------------------------
 
-uint32_t defaultHashTableHashFunction(const uint8_t *data, size_t size, size_t max){
-	return djb2_hash(data, size) % max;
+#define HASHTABLE_CTRL_EMPTY 0x80
+// slot of the old table already moved to the new one while growing, doesn't end probe sequences
+#define HASHTABLE_CTRL_MOVED 0xFE
+#define HASHTABLE_MIN_CAPACITY HASHTABLE_GROUP_SIZE
+
+static inline bool hashtable_ctrl_full(uint8_t ctrl){
+	return ctrl < HASHTABLE_CTRL_EMPTY;
+}
+
+static inline uint8_t hashtable_h7(uint64_t hash){
+	return hash >> 57;
 }
 
 // !trivial
-hashtable_t *hashtable_new_custom(size_t size, bool takeOwnership, hashFunction f){
-	hashtable_t *h = malloc(sizeof(hashtable_t));
-	h->size = size;
-	h->onws = takeOwnership;
-	h->hash = f != NULL ? f : defaultHashTableHashFunction;
-	h->values = calloc(h->size, sizeof(kv_node_t*));
-	h->collisions = 0;
-	return h;
+// bit mask of the control bytes equal to 'value' in the group starting at 'ctrl'
+static inline uint32_t hashtable_group_match(const uint8_t *ctrl, uint8_t value){
+	#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+	#else
+	uint32_t mask = 0;
+	for(size_t i = 0; i < HASHTABLE_GROUP_SIZE; i++)
+		mask |= (uint32_t)(ctrl[i] == value) << i;
+	return mask;
+	#endif
 }
 
-hashtable_t *hashtable_new(size_t size){
-	return hashtable_new_custom(size, false, defaultHashTableHashFunction);
+static inline uint64_t hashtable_hash(const hashtable_t *h, const void *key, size_t keySize){
+	if(h->hash == NULL)
+		return mix_hash(key, keySize);
+
+	return mix_hash_u64(h->hash(key, keySize, UINT32_MAX));
+}
+
+static inline const void *hashtable_slot_key(const hashtable_slot_t *slot){
+	return slot->keySize > HASHTABLE_INLINE_KEY_SIZE ? slot->key.heap : slot->key.inlined;
 }
 
 // !trivial
-void hashtable_destroy(hashtable_t *h){
-	for(size_t i = 0; i < h->size; i++){
-		if(h->values[i] != NULL){
-			kv_node_t *cursor = h->values[i];
-			while(cursor != NULL){
-				kv_node_t *t = cursor->next;
-
-				if(h->onws)
-					free(cursor->value);
-
-				free(cursor->key);
-				free(cursor);
-				cursor = t;
+static void hashtable_table_init(hashtable_table_t *t, size_t capacity){
+	t->capacity = capacity;
+	t->count = 0;
+	// slots never straddle cache lines
+	t->slots = aligned_alloc(64, capacity * sizeof(hashtable_slot_t));
+	t->ctrl = malloc(capacity + HASHTABLE_GROUP_SIZE);
+	memset(t->ctrl, HASHTABLE_CTRL_EMPTY, capacity + HASHTABLE_GROUP_SIZE);
+}
+
+static void hashtable_table_free(hashtable_table_t *t){
+	free(t->slots);
+	free(t->ctrl);
+	*t = (hashtable_table_t){0};
+}
+
+// !trivial
+static inline void hashtable_set_ctrl(hashtable_table_t *t, size_t i, uint8_t value){
+	t->ctrl[i] = value;
+	// mirrored tail
+	if(i < HASHTABLE_GROUP_SIZE)
+		t->ctrl[t->capacity + i] = value;
+}
+
+// !trivial
+static hashtable_slot_t *hashtable_table_find(const hashtable_table_t *t, uint64_t hash, const void *key, size_t keySize, size_t *index){
+	if(t->capacity == 0) return NULL;
+
+	size_t mask = t->capacity - 1;
+	size_t pos = hash & mask;
+	uint8_t h7 = hashtable_h7(hash);
+
+	while(true){
+		uint32_t match = hashtable_group_match(t->ctrl + pos, h7);
+		uint32_t empty = hashtable_group_match(t->ctrl + pos, HASHTABLE_CTRL_EMPTY);
+
+		// the probe sequence ends at the first empty slot
+		if(empty)
+			match &= (empty & -empty) - 1;
+
+		while(match){
+			size_t i = (pos + __builtin_ctz(match)) & mask;
+			hashtable_slot_t *slot = &t->slots[i];
+			if(slot->hash == (uint32_t)hash && slot->keySize == keySize && !memcmp(hashtable_slot_key(slot), key, keySize)){
+				if(index != NULL) *index = i;
+				return slot;
 			}
+
+			match &= match - 1;
 		}
+
+		if(empty) return NULL;
+		pos = (pos + HASHTABLE_GROUP_SIZE) & mask;
 	}
+}
 
-	free(h);
+// !trivial
+// place a slot known not to be in the table, 'h7' is it's control byte
+static void hashtable_table_insert(hashtable_table_t *t, const hashtable_slot_t *slot, uint8_t h7){
+	size_t mask = t->capacity - 1;
+	size_t pos = slot->hash & mask;
+
+	uint32_t empty;
+	while(!(empty = hashtable_group_match(t->ctrl + pos, HASHTABLE_CTRL_EMPTY)))
+		pos = (pos + HASHTABLE_GROUP_SIZE) & mask;
+
+	size_t i = (pos + __builtin_ctz(empty)) & mask;
+	t->slots[i] = *slot;
+	hashtable_set_ctrl(t, i, h7);
+	t->count++;
 }
 
 // !trivial
-uint32_t hashtable_set_by_hash(hashtable_t *h, uint32_t hash, const void *key, size_t keySize, void *value){
-	kv_node_t *cursor = h->values[hash];
-	if(cursor == NULL){
-		h->values[hash] = malloc(sizeof(kv_node_t));
-		cursor = h->values[hash];
-		cursor->next = NULL;
-		cursor->prev = NULL;
+// remove slot 'i', shifting back the following entries of the probe sequence so no tombstone is left
+static void hashtable_table_erase(hashtable_table_t *t, size_t i){
+	size_t mask = t->capacity - 1;
+	size_t j = i;
+
+	while(true){
+		j = (j + 1) & mask;
+		if(!hashtable_ctrl_full(t->ctrl[j])) break;
+
+		// an entry can only move back if the hole is between it's home slot and it's position
+		size_t home = t->slots[j].hash & mask;
+		if(((j - home) & mask) >= ((j - i) & mask)){
+			t->slots[i] = t->slots[j];
+			hashtable_set_ctrl(t, i, t->ctrl[j]);
+			i = j;
+		}
 	}
-	else{
-		h->collisions++;
-		while(cursor->next != NULL){
-			// if already in, return hash
-			if(cursor->keySize == keySize && !memcmp(cursor->key, key, keySize))
-				return hash;
-				
-			cursor = cursor->next;
+
+	hashtable_set_ctrl(t, i, HASHTABLE_CTRL_EMPTY);
+	t->count--;
+}
+
+// !trivial
+// move up to 'steps' slots of the old table to the new one
+static void hashtable_migrate(hashtable_t *h, size_t steps){
+	while(steps-- > 0 && h->migrated < h->old.capacity){
+		size_t i = h->migrated++;
+		if(hashtable_ctrl_full(h->old.ctrl[i])){
+			hashtable_table_insert(&h->table, &h->old.slots[i], h->old.ctrl[i]);
+			hashtable_set_ctrl(&h->old, i, HASHTABLE_CTRL_MOVED);
+			h->old.count--;
 		}
+	}
+
+	if(h->old.capacity > 0 && h->migrated == h->old.capacity)
+		hashtable_table_free(&h->old);
+}
+
+// !trivial
+static void hashtable_grow(hashtable_t *h){
+	// finish the previous growth first
+	if(h->old.capacity > 0)
+		hashtable_migrate(h, h->old.capacity);
+
+	h->old = h->table;
+	h->migrated = 0;
+	hashtable_table_init(&h->table, h->old.capacity * 2);
+}
+
+// !trivial
+hashtable_t *hashtable_new_custom(size_t size, bool takeOwnership, hashFunction f){
+	hashtable_t *h = calloc(1, sizeof(hashtable_t));
+	h->onws = takeOwnership;
+	h->hash = f;
+
+	size_t capacity = HASHTABLE_MIN_CAPACITY;
+	while(capacity < size)
+		capacity *= 2;
+
+	hashtable_table_init(&h->table, capacity);
+	return h;
+}
+
+hashtable_t *hashtable_new(size_t size){
+	return hashtable_new_custom(size, false, NULL);
+}
+
+// !trivial
+static void hashtable_table_destroy(hashtable_table_t *t, bool freeValues){
+	for(size_t i = 0; i < t->capacity; i++){
+		if(!hashtable_ctrl_full(t->ctrl[i])) continue;
 
-		cursor->next = malloc(sizeof(kv_node_t));
-		cursor->next->prev = cursor;
-		cursor->next->next = NULL;
-		cursor = cursor->next;
+		if(freeValues)
+			free(t->slots[i].value);
+
+		if(t->slots[i].keySize > HASHTABLE_INLINE_KEY_SIZE)
+			free(t->slots[i].key.heap);
 	}
 
-	cursor->key = malloc(keySize);
-	memcpy(cursor->key, key, keySize);
-	cursor->keySize = keySize;
-	cursor->value = value;
+	hashtable_table_free(t);
+}
 
-	return hash;
+void hashtable_destroy(hashtable_t *h){
+	hashtable_table_destroy(&h->table, h->onws);
+	hashtable_table_destroy(&h->old, h->onws);
+	free(h);
 }
 
+size_t hashtable_size(const hashtable_t *h){
+	return h->table.count + h->old.count;
+}
+
+// !trivial
+static hashtable_slot_t *hashtable_find(const hashtable_t *h, uint64_t hash, const void *key, size_t keySize){
+	hashtable_slot_t *slot = hashtable_table_find(&h->table, hash, key, keySize, NULL);
+	if(slot == NULL && h->old.capacity > 0)
+		slot = hashtable_table_find(&h->old, hash, key, keySize, NULL);
+
+	return slot;
+}
+
+// !trivial
 uint32_t hashtable_set_bin(hashtable_t *h, void *key, size_t keySize, void *value){
-	uint32_t hash = h->hash(key, keySize, h->size);
-	return hashtable_set_by_hash(h, hash, key, keySize, value);
+	uint64_t hash = hashtable_hash(h, key, keySize);
+
+	if(h->old.capacity > 0)
+		hashtable_migrate(h, HASHTABLE_MIGRATE_STEP);
+
+	// if already in, it's not set
+	if(hashtable_find(h, hash, key, keySize) != NULL)
+		return hash;
+
+	if((h->table.count + 1) * 100 > h->table.capacity * HASHTABLE_MAX_LOAD){
+		hashtable_grow(h);
+		hashtable_migrate(h, HASHTABLE_MIGRATE_STEP);
+	}
+
+	hashtable_slot_t slot = {.hash = (uint32_t)hash, .keySize = keySize, .value = value};
+	if(keySize > HASHTABLE_INLINE_KEY_SIZE){
+		slot.key.heap = malloc(keySize);
+		memcpy(slot.key.heap, key, keySize);
+	}
+	else
+		memcpy(slot.key.inlined, key, keySize);
+
+	hashtable_table_insert(&h->table, &slot, hashtable_h7(hash));
+	return hash;
 }
 
 uint32_t hashtable_set(hashtable_t *h, char *key, void *value){
@@ -427,52 +770,44 @@ uint32_t hashtable_set(hashtable_t *h, char *key, void *value){
 }
 
 // !trivial
-kv_node_t *hashtable_get_by_hash(hashtable_t *h, uint32_t hash, const void *key, size_t keySize, bool remove){
-	kv_node_t *node = h->values[hash];
+void *hashtable_remove_bin(hashtable_t *h, void *key, size_t keySize){
+	uint64_t hash = hashtable_hash(h, key, keySize);
 
-	while(node != NULL){
-		if(node->keySize == keySize && !memcmp(node->key, key, keySize)){
-			if(remove){
-				if(node->prev != NULL)
-					node->prev->next = node->next;
-				if(node->next != NULL)
-					node->next->prev = node->prev;
-				if(node == h->values[hash])
-					h->values[hash] = node->next;
-			}
+	if(h->old.capacity > 0)
+		hashtable_migrate(h, HASHTABLE_MIGRATE_STEP);
 
-			break;			
-		}
-		node = node->next;
+	size_t i;
+	hashtable_table_t *t = &h->table;
+	hashtable_slot_t *slot = hashtable_table_find(t, hash, key, keySize, &i);
+	if(slot == NULL && h->old.capacity > 0){
+		t = &h->old;
+		slot = hashtable_table_find(t, hash, key, keySize, &i);
 	}
 
-	return node;
-}
+	if(slot == NULL) return NULL;
 
-void *hashtable_get_raw(hashtable_t *h, void *key, size_t keySize, bool remove){
-	uint32_t hash = h->hash(key, keySize, h->size);
-	kv_node_t *kv = hashtable_get_by_hash(h, hash, key, keySize, remove);
-	if(kv == NULL) return NULL;
-	void *value = kv->value;
+	void *value = slot->value;
+	if(slot->keySize > HASHTABLE_INLINE_KEY_SIZE)
+		free(slot->key.heap);
 
-	if(remove){
-		free(kv->key);
-		free(kv);
+	// the old table is being drained, a moved mark is enough there
+	if(t == &h->old){
+		hashtable_set_ctrl(t, i, HASHTABLE_CTRL_MOVED);
+		t->count--;
 	}
+	else
+		hashtable_table_erase(t, i);
 
 	return value;
 }
 
-void *hashtable_remove_bin(hashtable_t *h, void *key, size_t keySize){
-	return hashtable_get_raw(h, key, keySize, true);
-}
-
 void *hashtable_remove(hashtable_t *h, char *key){
 	return hashtable_remove_bin(h, key, strlen(key));
 }
 
 void *hashtable_get_bin(hashtable_t *h, void *key, size_t keySize){
-	return hashtable_get_raw(h, key, keySize, false);
+	hashtable_slot_t *slot = hashtable_find(h, hashtable_hash(h, key, keySize), key, keySize);
+	return slot != NULL ? slot->value : NULL;
 }
 
 void *hashtable_get(hashtable_t *h, char *key){
@@ -480,20 +815,25 @@ void *hashtable_get(hashtable_t *h, char *key){
 }
 
 bool hashtable_exists_bin(hashtable_t *h, void *key, size_t keySize){
-	return hashtable_get_bin(h, key, keySize) == NULL ? false : true;
+	return hashtable_find(h, hashtable_hash(h, key, keySize), key, keySize) != NULL;
 }
 
 bool hashtable_exists(hashtable_t *h, char *key){
-	return hashtable_get_bin(h, key, strlen(key)) == NULL ? false : true;
+	return hashtable_exists_bin(h, key, strlen(key));
 }
 
 // ------------------------------------------------------------ Dictionary ---------------------------------------------------------
 
+#define DICT_MIN_CAPACITY 16
+
 // !trivial
 dict_t *dict_new_custom(size_t size, bool takeOwnership){
-	dict_t *d = malloc(sizeof(dict_t));
-	d->h = hashtable_new_custom(size, takeOwnership, NULL);
-	d->l = list_new_custom_queue(true, NULL);
+	dict_t *d = calloc(1, sizeof(dict_t));
+	d->h = hashtable_new_custom(size, false, NULL);
+	d->onws = takeOwnership;
+	d->capacity = size > DICT_MIN_CAPACITY ? size : DICT_MIN_CAPACITY;
+	d->entries = malloc(d->capacity * sizeof(key_value_t));
+	d->firstHole = SIZE_MAX;
 	return d;
 }
 
@@ -502,38 +842,109 @@ dict_t *dict_new(){
 }
 
 size_t dict_size(const dict_t *d){
-	return d->l->size;
+	return d->size;
 }
 
 // !trivial
 void dict_destroy(dict_t *d){
+	if(d->onws){
+		for(size_t i = d->head; i < d->used; i++){
+			if(d->entries[i].key != NULL)
+				free(d->entries[i].value);
+		}
+	}
+
 	hashtable_destroy(d->h);
-	list_destroy(d->l);
+	free(d->entries);
 	free(d);
 }
 
+// !trivial
+void dict_compact(dict_t *d){
+	size_t j = 0;
+	for(size_t i = d->head; i < d->used; i++){
+		key_value_t *kv = &d->entries[i];
+		if(kv->key == NULL) continue;
+
+		if(i != j){
+			d->entries[j] = *kv;
+			hashtable_find(d->h, hashtable_hash(d->h, kv->key, kv->keySize), kv->key, kv->keySize)->value = (void*)(j + 1);
+		}
+		j++;
+	}
+
+	d->used = j;
+	d->head = 0;
+	d->firstHole = SIZE_MAX;
+}
+
+// !trivial
+// index in 'entries' of position 'pos', SIZE_MAX if out of bounds
+static size_t dict_index(dict_t *d, size_t pos){
+	if(pos >= d->size) return SIZE_MAX;
+
+	size_t i = d->head + pos;
+	if(i >= d->firstHole){
+		dict_compact(d);
+		i = pos;
+	}
+
+	return i;
+}
+
+// !trivial
+// leave a hole at index 'i', the key must be already gone from the table
+static void dict_remove_index(dict_t *d, size_t i){
+	d->entries[i].key = NULL;
+	d->size--;
+
+	if(d->size == 0){
+		d->used = 0;
+		d->head = 0;
+		d->firstHole = SIZE_MAX;
+		return;
+	}
+
+	// holes at the ends just shrink the used range
+	if(i == d->head){
+		while(d->entries[d->head].key == NULL)
+			d->head++;
+	}
+	else if(i == d->used - 1){
+		while(d->entries[d->used - 1].key == NULL)
+			d->used--;
+	}
+	else if(i < d->firstHole)
+		d->firstHole = i;
+
+	// no holes left in between
+	if(d->used - d->head == d->size)
+		d->firstHole = SIZE_MAX;
+	else if(d->firstHole < d->head)
+		d->firstHole = d->head;
+}
+
 // !trivial
 key_value_t dict_set_bin(dict_t *d, size_t pos, void *key, size_t keySize, void *value){
-	// if list has pos
-	node_t *node = list_node_at(d->l, pos);
-	if(node == NULL) return (key_value_t){0};
+	// if dict has pos
+	size_t i = dict_index(d, pos);
+	if(i == SIZE_MAX) return (key_value_t){0};
 	
 	// if key isn't already used
-	uint32_t hash = d->h->hash(key, keySize, d->h->size);
-	const kv_node_t *hentry = hashtable_get_by_hash(d->h, hash, key, keySize, false);
-	if(hentry != NULL) return (key_value_t){0};
+	if(hashtable_exists_bin(d->h, key, keySize)) return (key_value_t){0};
 
 	// save old
-	key_value_t *kv = node->value;
+	key_value_t *kv = &d->entries[i];
 	key_value_t ret = *kv;
 
-	// alter list node
+	// alter entry
 	kv->value = value;
 	kv->key = key;
 	kv->keySize = keySize;
 
-	// set on hashtable
-	hashtable_set_by_hash(d->h, hash, key, keySize, node);
+	// move on hashtable from the old key to the new one
+	hashtable_remove_bin(d->h, ret.key, ret.keySize);
+	hashtable_set_bin(d->h, key, keySize, (void*)(i + 1));
 
 	return ret;
 }
@@ -544,17 +955,22 @@ key_value_t dict_set(dict_t *d, size_t pos, char *key, void *value){
 
 // !trivial
 int64_t dict_add_bin(dict_t *d, void *key, size_t keySize, void *value){
-	uint32_t hash = d->h->hash(key, keySize, d->h->size);
-	const kv_node_t *hentry = hashtable_get_by_hash(d->h, hash, key, keySize, false);
-	if(hentry != NULL) return -1;
-	
-	key_value_t *kv = malloc(sizeof(key_value_t));
-	kv->key = key;
-	kv->keySize = keySize;
-	kv->value = value;
-	list_push(d->l, kv);
-	hashtable_set_by_hash(d->h, hash, key, keySize, d->l->last);
-	return d->l->size - 1;
+	if(hashtable_exists_bin(d->h, key, keySize)) return -1;
+
+	if(d->used == d->capacity){
+		// reuse the holes when they are half of the array, grow otherwise
+		if((d->used - d->size) * 2 >= d->capacity)
+			dict_compact(d);
+		else{
+			d->capacity *= 2;
+			d->entries = realloc(d->entries, d->capacity * sizeof(key_value_t));
+		}
+	}
+
+	size_t i = d->used++;
+	d->entries[i] = (key_value_t){.key = key, .keySize = keySize, .value = value};
+	hashtable_set_bin(d->h, key, keySize, (void*)(i + 1));
+	return d->size++;
 }
 
 int64_t dict_add(dict_t *d, char *key, void *value){
@@ -564,30 +980,26 @@ int64_t dict_add(dict_t *d, char *key, void *value){
 // !trivial
 key_value_t dict_get_bin_raw(dict_t *d, void *key, size_t keySize, bool remove){
 	// get table entry, remove from table if necessary
-	node_t *node = hashtable_get_raw(d->h, key, keySize, remove);
-	if(node == NULL) return (key_value_t){0};
+	size_t i = (size_t)(remove ? hashtable_remove_bin(d->h, key, keySize) : hashtable_get_bin(d->h, key, keySize));
+	if(i == 0) return (key_value_t){0};
 
-	// value
-	key_value_t value = *(key_value_t*)node->value;
-
-	// remove from list
+	key_value_t value = d->entries[i - 1];
 	if(remove)
-		list_remove_node(d->l, node);
+		dict_remove_index(d, i - 1);
 
 	return value;
 }
 
 // !trivial
 key_value_t dict_get_at_raw(dict_t *d, size_t pos, bool remove){
-	const node_t *node = list_node_at(d->l, pos);
-	if(node == NULL) return (key_value_t){0};
+	size_t i = dict_index(d, pos);
+	if(i == SIZE_MAX) return (key_value_t){0};
 
-	key_value_t value = *(key_value_t*)node->value;
+	key_value_t value = d->entries[i];
 	
 	if(remove){
 		hashtable_remove_bin(d->h, value.key, value.keySize);
-		void *v = list_remove_node(d->l, (node_t*)node);
-		free(v);
+		dict_remove_index(d, i);
 	}
 
 	return value;
@@ -618,34 +1030,33 @@ key_value_t dict_remove_at(dict_t *d, size_t pos){
 }
 
 bool dict_exists_bin(const dict_t *d, void *key, size_t keySize){
-	return dict_get_bin_raw((dict_t*)d, key, keySize, false).key != NULL;
+	return hashtable_exists_bin(d->h, key, keySize);
 }
 
 bool dict_exists(const dict_t *d, char *key){
-	return dict_get_bin_raw((dict_t*)d, key, strlen(key), false).key != NULL;
+	return hashtable_exists_bin(d->h, key, strlen(key));
 }
 
 bool dict_exists_at(const dict_t *d, size_t pos){
-	return dict_get_at_raw((dict_t*)d, pos, false).key != NULL;
+	return pos < d->size;
 }
 
 // !trivial
 key_value_t dict_next(dict_ite *i){
-	if(i->node == NULL){
-		i->yield = false;
-		return (key_value_t){0};
+	while(i->pos < i->d->used){
+		key_value_t kv = i->d->entries[i->pos++];
+		if(kv.key != NULL) return kv;
 	}
 
-	key_value_t kv = *(key_value_t*)i->node->value;
-	i->node = i->node->next;
-	return kv;
+	i->yield = false;
+	return (key_value_t){0};
 }
 
 dict_ite dict_iterate(const dict_t *d){
 	return (dict_ite){
 		.next = dict_next,
 		.d = (dict_t*)d,
-		.node = d->l->first,
+		.pos = d->head,
 		.yield = true,
 	};
 }
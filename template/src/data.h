@@ -5,6 +5,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include "arena.h"
+#include "pool.h"
 
 // ------------------------------------------------------------ Types --------------------------------------------------------------
 
@@ -40,13 +42,41 @@ typedef enum{
 */
 typedef cmp_t(*cmpFunc)(void *a, void *b);
 
+/**
+ * @brief hash of a value for 'list_set_unique'. Equal values must have the same hash
+*/
+typedef uint64_t(*valueHashFunc)(const void *value);
+
+/**
+ * @brief equality of two values for 'list_set_unique'
+*/
+typedef bool(*valueEqFunc)(const void *a, const void *b);
+
 // ------------------------------------------------------------ Linked list --------------------------------------------------------
 
+#define LIST_INDEX_MIN_CAPACITY 16
+
 typedef enum{
 	list_type_queue,
 	list_type_stack
 }list_type_t;
 
+typedef struct{
+	uint64_t hash;
+	node_t *node;											/**< NULL if the slot is free */
+}list_index_slot_t;
+
+/**
+ * @brief open addressing table of the nodes of a list, by value
+*/
+typedef struct{
+	list_index_slot_t *slots;
+	size_t capacity;
+	size_t count;
+	valueHashFunc hash;
+	valueEqFunc eq;
+}list_index_t;
+
 typedef struct{
 	node_t *first;
 	node_t *last;
@@ -54,6 +84,10 @@ typedef struct{
 	size_t size;
 	list_type_t type;
 	cmpFunc cmpFunc;
+	arena_t *arena;											/**< nodes are allocated from it when not NULL */
+	pool_t *pool;											/**< nodes are allocated from it when not NULL */
+	bool poolOwned;											/**< true if 'pool' is destroyed with the list */
+	list_index_t *index;									/**< values in the list when unique, see 'list_set_unique' */
 }list_t;
 
 typedef struct list_ite list_ite;
@@ -111,6 +145,38 @@ list_t *list_new_custom_queue(bool takeOwnership, cmpFunc priorityCmp);
 */
 list_t *list_new_custom_stack(bool takeOwnership, cmpFunc priorityCmp);
 
+/**
+ * @brief creates a new list with it's nodes allocated from an arena. 'list_destroy' and popping don't free anything,
+ * the memory is released with the arena. Values are not owned by the list
+ * @param arena: arena to allocate from, must outlive the list
+ * @param type: queue or stack
+ * @param priorityCmp: same as 'list_new_custom_queue'. Pass 'NULL' if no priority check is desired
+*/
+list_t *list_new_arena(arena_t *arena, list_type_t type, cmpFunc priorityCmp);
+
+/**
+ * @brief creates a new list with it's nodes allocated from a pool, popped nodes are reused by the next pushes
+ * so a list that keeps pushing and popping stops calling malloc
+ * @param type: queue or stack
+ * @param takeOwnership: true if pushed values should be freed along with the list deallocation
+ * @param priorityCmp: same as 'list_new_custom_queue'. Pass 'NULL' if no priority check is desired
+ * @param pool: pool of 'sizeof(node_t)' objects shared with other lists, it must outlive them.
+ * Pass 'NULL' to give the list a pool of it's own
+*/
+list_t *list_new_pooled(list_type_t type, bool takeOwnership, cmpFunc priorityCmp, pool_t *pool);
+
+/**
+ * @brief make the list keep it's values unique with a hash index. From now on 'list_push' rejects a value equal to one
+ * already in, in O(1) instead of scanning with 'cmpFunc', and 'list_exists' uses 'eq'. 'cmpFunc' still orders the values,
+ * for priorities without the O(n) scan use a 'heap_t' and keep the seen values in a set.
+ * Values already in the list are indexed, duplicates among them are kept
+ * @param hash: hash of a value, equal values must have the same hash
+ * @param eq: true if two values are equal
+ * @return false if the list is allocated from an arena, the index can't be released with it
+ * @attention O(n)
+*/
+bool list_set_unique(list_t *l, valueHashFunc hash, valueEqFunc eq);
+
 /**
  * @brief destroys an list. If it was created with 'takeOwnership' as true, then values inside will be deallocated alongside the list
 */
@@ -118,7 +184,8 @@ void list_destroy(list_t *l);
 
 /**
  * @brief pushes a value to the list, accordingly to the type (queue or stack) and comparison (priority and uniqueness)
- * @attention Avg: O(1), Worst: O(n)
+ * @return the new node or NULL if the value was rejected
+ * @attention Avg: O(1), Worst: O(n). Uniqueness with 'list_set_unique' is O(1), only the priority scan is O(n)
 */
 node_t *list_push(list_t *l, void *value);
 
@@ -129,8 +196,8 @@ node_t *list_push(list_t *l, void *value);
 void *list_pop(list_t *l);
 
 /**
- * @brief appends two lists, both must different and must have same memory owning of their data.
- * If one owns and the other doesn't, then the function returns immediately
+ * @brief appends two lists, both must different and must have same memory owning of their data and be allocated from the same arena or pool.
+ * If one owns and the other doesn't, or the arenas or pools differ, or one of them is unique, then the function returns immediately
  * @param l: the destination list
  * @param consumed: the list to be added and then destroyed
  * @attention O(1)
@@ -138,11 +205,11 @@ void *list_pop(list_t *l);
 void list_merge(list_t *dest, list_t *consumed);
 
 /**
- * @brief check if an value already exists on a list based on the given 'cmpFunc'
+ * @brief check if an value already exists on a list based on the given 'cmpFunc', or the 'eq' of 'list_set_unique'
  * @param l: the list
  * @param value: the value to be compared
  * @return true if value exists
- * @attention O(n)
+ * @attention O(n), Avg: O(1) with 'list_set_unique'
 */
 bool list_exists(const list_t *l, void *value);
 
@@ -180,6 +247,7 @@ typedef struct{
 	size_t allocated;
 	size_t size;
 	bool onws;
+	arena_t *arena;											/**< storage is allocated from it when not NULL */
 }array_t;
 
 /**
@@ -196,6 +264,14 @@ array_t *array_new_custom(bool takeOwnership, size_t blockSize);
 */
 array_t *array_new(void);
 
+/**
+ * @brief creates a new dynamic array allocated from an arena. 'array_destroy' doesn't free anything,
+ * the memory is released with the arena. Values are not owned by the array
+ * @param arena: arena to allocate from, must outlive the array
+ * @param blockSize: the block size to be allocated at the start and reallocated by each time the array overflows
+*/
+array_t *array_new_arena(arena_t *arena, size_t blockSize);
+
 /**
  * @brief destroys an array. If it was created with 'takeOwnership' as true, then values inside will be deallocated alongside the array
 */
@@ -244,37 +320,70 @@ void *array_pop(array_t *a, size_t pos);
 
 // ------------------------------------------------------------ Hash table ---------------------------------------------------------
 
+/**
+ * @brief hash function for the hashtable, must return a value smaller than 'max'
+*/
 typedef uint32_t(*hashFunction)(const uint8_t *data, size_t size, size_t max);
 
-typedef struct kv_node_t kv_node_t;
-struct kv_node_t{
-	void* value;
-	kv_node_t *next;
-	kv_node_t *prev;
-	void *key;
-	size_t keySize;
-};
+// keys up to this size are stored inside the table, bigger ones are copied to the heap
+#define HASHTABLE_INLINE_KEY_SIZE 16
+
+// number of control bytes probed at a time
+#define HASHTABLE_GROUP_SIZE 16
+
+// maximum load of the table in percent, it grows to twice the capacity when crossed
+#define HASHTABLE_MAX_LOAD 75
+
+// number of slots moved from the old table to the new one on each write while growing
+#define HASHTABLE_MIGRATE_STEP 16
+
+typedef struct{
+	uint32_t hash;											/**< low bits of the hash, the control byte holds the high ones */
+	uint32_t keySize;
+	void *value;
+	union{
+		uint8_t inlined[HASHTABLE_INLINE_KEY_SIZE];
+		void *heap;
+	}key;
+}hashtable_slot_t;
+
+/**
+ * @brief one open addressing table: a control byte per slot, plus a copy of the first 'HASHTABLE_GROUP_SIZE' control bytes
+ * at the end so groups can be loaded at any slot without wrapping around
+*/
+typedef struct{
+	uint8_t *ctrl;
+	hashtable_slot_t *slots;
+	size_t capacity;										/**< always a power of two */
+	size_t count;
+}hashtable_table_t;
 
+/**
+ * @brief open addressing hashtable with linear probing. Control bytes hold 7 bits of the hash of each slot
+ * and are compared 'HASHTABLE_GROUP_SIZE' at a time with SIMD when available.
+ * Removal shifts the following entries back instead of leaving tombstones.
+ * Growth is incremental: the entries of the old table are moved to the new one a few at a time on each write
+*/
 typedef struct{
-	kv_node_t **values;
-	uint32_t size;
+	hashtable_table_t table;
+	hashtable_table_t old;									/**< table being migrated while growing, empty otherwise */
+	size_t migrated;										/**< slots of 'old' already moved */
 	bool onws;
-	hashFunction hash;
-	int collisions;
+	hashFunction hash;										/**< NULL to use 'mix_hash' */
 }hashtable_t;
 
 /**
- * @brief creates a new hashtable that uses djb2 as a hash function
+ * @brief creates a new hashtable that uses 'mix_hash' as a hash function
  * Values in the hashtable are NOT freed when 'hashtable_destroy' is called
- * @param size: the size of the table, the more the less conflicts
+ * @param size: initial capacity of the table, it grows as needed
 */
 hashtable_t *hashtable_new(size_t size);
 
 /**
  * @brief creates a new hashtable that uses a defined hash function
- * @param size: the size of the table, the more the less conflicts
+ * @param size: initial capacity of the table, it grows as needed
  * @param takeOwnership: true if inserted values should be freed along with the hashtable deallocation 
- * @param f: a hash function. Pass NULL to use the default one
+ * @param f: a hash function, it's result is mixed further so all bits are used. Pass NULL to use the default one
 */
 hashtable_t *hashtable_new_custom(size_t size, bool takeOwnership, hashFunction f);
 
@@ -283,6 +392,11 @@ hashtable_t *hashtable_new_custom(size_t size, bool takeOwnership, hashFunction
 */
 void hashtable_destroy(hashtable_t *ht);
 
+/**
+ * @brief number of keys in the hashtable
+*/
+size_t hashtable_size(const hashtable_t *h);
+
 /**
  * @brief set a value in the hashtable using a string key.
  * If value is present then it's not set
@@ -342,11 +456,19 @@ bool hashtable_exists_bin(hashtable_t *h, void *key, size_t keySize);
 // ------------------------------------------------------------ Dictionary ---------------------------------------------------------
 
 /**
- * @brief a dict is an 'list_t' that holds 'key_value_t*' inside it, and a 'hashtable_t' to map 'void*' keys back to 'list_t' 'node_t's
+ * @brief a dict keeps it's entries in insertion order in a dense array, and a 'hashtable_t' maps the keys to their position in it.
+ * Removed entries are left as holes, with a NULL key, until the dict is compacted. That happens on demand, when a position
+ * past a hole is accessed or when the holes take half the array. Removing the first or the last entry leaves no hole
 */
 typedef struct{
-	list_t *l;
-	hashtable_t *h;
+	key_value_t *entries;
+	size_t used;											/**< entries in use, holes included */
+	size_t capacity;
+	size_t size;											/**< entries not removed */
+	size_t head;											/**< first entry not removed, the ones before it are holes */
+	size_t firstHole;										/**< first hole after 'head', SIZE_MAX if none */
+	hashtable_t *h;											/**< key to position in 'entries' + 1 */
+	bool onws;
 }dict_t;
 
 /**
@@ -357,7 +479,7 @@ dict_t *dict_new();
 
 /**
  * @brief creates a new dictionary with specified hashtable size.
- * @param size: The underlying hashtable size
+ * @param size: The expected number of entries
  * @param takeOwnership: true if inserted values should be freed along with the dictionary deallocation 
 */
 dict_t *dict_new_custom(size_t size, bool takeOwnership);
@@ -382,6 +504,10 @@ void *dict_get(const dict_t *d, char *key);
 
 void *dict_get_bin(const dict_t *d, void *key, size_t keySize);
 
+/**
+ * @brief return the entry at position 'pos', in insertion order
+ * @attention O(1), O(n) when the dict has to be compacted first
+*/
 key_value_t dict_get_at(const dict_t *d, size_t pos);
 
 
@@ -398,6 +524,12 @@ bool dict_exists_bin(const dict_t *d, void *key, size_t keySize);
 
 bool dict_exists_at(const dict_t *d, size_t pos);
 
+/**
+ * @brief close the holes left by removed entries
+ * @attention O(n)
+*/
+void dict_compact(dict_t *d);
+
 
 typedef struct dict_ite dict_ite;
 typedef key_value_t (*dict_ite_next_func)(dict_ite *ite);
@@ -405,11 +537,11 @@ struct dict_ite{
 	dict_ite_next_func next;
 	bool yield;
 	dict_t *d;
-	node_t *node;
+	size_t pos;
 };
 
 /**
- * @brief return an iterator that iterates in place through the dictionary 
+ * @brief return an iterator that iterates in place through the dictionary, in insertion order
 */
 dict_ite dict_iterate(const dict_t *d);
 
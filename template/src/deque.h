@@ -0,0 +1,128 @@
+#ifndef _DEQUE_HEADER_
+#define _DEQUE_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Typed double ended queues generated by a macro. Elements are stored inline in a power of two ring buffer
+ * that doubles when full, so pushing and popping at either end is O(1) and doesn't allocate once the
+ * queue reached it's biggest size. Use it as the BFS queue instead of a 'list_t' of boxed values.
+ * @details
+ * DEQUE_DEFINE(pointq, point_t)
+ *
+ * pointq_t *q = pointq_new(0);
+ * pointq_push_back(q, start);
+ * while(pointq_size(q) > 0){
+ * 	 point_t p = pointq_pop_front(q);
+ * 	 ...
+ * }
+ * pointq_destroy(q);
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+#define DEQUE_MIN_CAPACITY 64
+
+// ------------------------------------------------------------ Deque --------------------------------------------------------------
+
+/**
+ * @brief define the type 'name_t', a deque of 'T', and it's functions:
+ * - name_t *name_new(size_t capacity): rounded up to a power of two, 0 for the default
+ * - void name_destroy(name_t *q)
+ * - size_t name_size(const name_t *q)
+ * - void name_clear(name_t *q): remove all elements, keeping the memory
+ * - void name_push_back(name_t *q, T value)
+ * - void name_push_front(name_t *q, T value)
+ * - T name_pop_back(name_t *q): the deque must not be empty
+ * - T name_pop_front(name_t *q): the deque must not be empty
+ * - T *name_front(const name_t *q): pointer to the first element or NULL if empty
+ * - T *name_back(const name_t *q): pointer to the last element or NULL if empty
+ * - T *name_at(const name_t *q, size_t pos): pointer to the element 'pos' places from the front or NULL if out of bounds
+ *
+ * Pointers to elements are invalidated by pushes
+*/
+#define DEQUE_DEFINE(name, T)																					\
+																												\
+typedef struct{																									\
+	T *data;																									\
+	size_t head;																								\
+	size_t size;																								\
+	size_t capacity;																							\
+}name##_t;																										\
+																												\
+static inline name##_t *name##_new(size_t capacity){															\
+	name##_t *q = malloc(sizeof(name##_t));																		\
+	q->head = 0;																								\
+	q->size = 0;																								\
+	q->capacity = DEQUE_MIN_CAPACITY;																			\
+	while(q->capacity < capacity)																				\
+		q->capacity <<= 1;																						\
+	q->data = malloc(q->capacity * sizeof(T));																	\
+	return q;																									\
+}																												\
+																												\
+static inline void name##_destroy(name##_t *q){																	\
+	if(q == NULL) return;																						\
+	free(q->data);																								\
+	free(q);																									\
+}																												\
+																												\
+static inline size_t name##_size(const name##_t *q){															\
+	return q->size;																								\
+}																												\
+																												\
+static inline void name##_clear(name##_t *q){																	\
+	q->head = 0;																								\
+	q->size = 0;																								\
+}																												\
+																												\
+/* double the buffer, the elements that wrapped around go right after the old end */						\
+static inline void name##_grow(name##_t *q){																	\
+	size_t old = q->capacity;																					\
+	q->capacity <<= 1;																							\
+	q->data = realloc(q->data, q->capacity * sizeof(T));														\
+	if(q->head + q->size > old)																					\
+		memcpy(q->data + old, q->data, (q->head + q->size - old) * sizeof(T));									\
+}																												\
+																												\
+static inline void name##_push_back(name##_t *q, T value){													\
+	if(q->size == q->capacity)																					\
+		name##_grow(q);																							\
+	q->data[(q->head + q->size++) & (q->capacity - 1)] = value;													\
+}																												\
+																												\
+static inline void name##_push_front(name##_t *q, T value){													\
+	if(q->size == q->capacity)																					\
+		name##_grow(q);																							\
+	q->head = (q->head - 1) & (q->capacity - 1);																\
+	q->data[q->head] = value;																					\
+	q->size++;																									\
+}																												\
+																												\
+static inline T name##_pop_front(name##_t *q){																\
+	T value = q->data[q->head];																					\
+	q->head = (q->head + 1) & (q->capacity - 1);																\
+	q->size--;																									\
+	return value;																								\
+}																												\
+																												\
+static inline T name##_pop_back(name##_t *q){																	\
+	return q->data[(q->head + --q->size) & (q->capacity - 1)];													\
+}																												\
+																												\
+static inline T *name##_at(const name##_t *q, size_t pos){													\
+	return pos < q->size ? &q->data[(q->head + pos) & (q->capacity - 1)] : NULL;								\
+}																												\
+																												\
+static inline T *name##_front(const name##_t *q){																\
+	return name##_at(q, 0);																						\
+}																												\
+																												\
+static inline T *name##_back(const name##_t *q){																\
+	return q->size > 0 ? name##_at(q, q->size - 1) : NULL;														\
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "flood_fill.h"
+#include "deque.h"
 
 typedef struct{
 	size_t x;
@@ -6,27 +7,21 @@ typedef struct{
 	int d;
 }fill_pos_t;
 
-void fill_pos_push(list_t *q, size_t x, size_t y){
-	fill_pos_t *new = malloc(sizeof(fill_pos_t));
-	new->y = y;
-	new->x = x;
-	list_push(q, new); 
-}
+// positions are stored inline in a ring buffer, the fill stops allocating once the queue reached it's biggest size
+DEQUE_DEFINE(fill_queue, fill_pos_t)
 
-void fill_pos_pop(list_t *q, fill_pos_t *pos){
-	fill_pos_t *got = list_pop(q);
-	*pos = *got;
-	free(got);
+static void fill_pos_push(fill_queue_t *q, size_t x, size_t y){
+	fill_queue_push_back(q, (fill_pos_t){.x = x, .y = y});
 }
 
 void flood_fill_int(int **matrix, size_t height, size_t width, size_t startx, size_t starty, int empty, int fill){
-	list_t *q = list_new_custom_queue(true, NULL);
+	fill_queue_t *q = fill_queue_new(0);
 	
 	fill_pos_push(q, startx, starty);
 
 	fill_pos_t n;
 	while(q->size > 0){
-		fill_pos_pop(q, &n);
+		n = fill_queue_pop_front(q);
 
 		if(matrix[n.y][n.x] == empty){
 			matrix[n.y][n.x] = fill;
@@ -49,17 +44,17 @@ void flood_fill_int(int **matrix, size_t height, size_t width, size_t startx, si
 		}
 	}
 
-	list_destroy(q);
+	fill_queue_destroy(q);
 }
 
 void flood_fill_matrix(matrix_t *m, size_t startx, size_t starty, int empty, int fill){
-	list_t *q = list_new_custom_queue(true, NULL);
+	fill_queue_t *q = fill_queue_new(0);
 	
 	fill_pos_push(q, startx, starty);
 
 	fill_pos_t n;
 	while(q->size > 0){
-		fill_pos_pop(q, &n);
+		n = fill_queue_pop_front(q);
 
 		if(m->rows[n.y][n.x] == empty){
 			m->rows[n.y][n.x] = fill;
@@ -82,25 +77,21 @@ void flood_fill_matrix(matrix_t *m, size_t startx, size_t starty, int empty, int
 		}
 	}
 
-	list_destroy(q);
+	fill_queue_destroy(q);
 }
 
-void fill_pos_push_d(list_t *q, size_t x, size_t y, size_t d){
-	fill_pos_t *new = malloc(sizeof(fill_pos_t));
-	new->y = y;
-	new->x = x;
-	new->d = d;
-	list_push(q, new); 
+static void fill_pos_push_d(fill_queue_t *q, size_t x, size_t y, size_t d){
+	fill_queue_push_back(q, (fill_pos_t){.x = x, .y = y, .d = d});
 }
 
 void flood_fill_matrix_distance(matrix_t *m, size_t startx, size_t starty, int maxDistance){
-	list_t *q = list_new_custom_queue(true, NULL);
+	fill_queue_t *q = fill_queue_new(0);
 	
 	fill_pos_push_d(q, startx, starty, 0);
 
 	fill_pos_t n;
 	while(q->size > 0){
-		fill_pos_pop(q, &n);
+		n = fill_queue_pop_front(q);
 
 		if(
 			n.d <= maxDistance &&
@@ -129,5 +120,5 @@ void flood_fill_matrix_distance(matrix_t *m, size_t startx, size_t starty, int m
 		}
 	}
 
-	list_destroy(q);
+	fill_queue_destroy(q);
 }
\ No newline at end of file
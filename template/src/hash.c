@@ -22,3 +22,33 @@ uint64_t djb2_hash(const uint8_t *data, size_t size){
 		
     return hash;
 }
+
+// murmur3 finalizer
+uint64_t mix_hash_u64(uint64_t value){
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ULL;
+	value ^= value >> 33;
+	return value;
+}
+
+// !trivial
+uint64_t mix_hash(const uint8_t *data, size_t size){
+	uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (size * 0xc6a4a7935bd1e995ULL);
+
+	while(size >= 8){
+		uint64_t word;
+		memcpy(&word, data, 8);
+		hash = (hash ^ mix_hash_u64(word)) * 0x9e3779b97f4a7c15ULL;
+		data += 8;
+		size -= 8;
+	}
+
+	// last bytes packed in a single word
+	uint64_t tail = 0;
+	memcpy(&tail, data, size);
+	hash ^= tail;
+
+	return mix_hash_u64(hash);
+}
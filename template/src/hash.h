@@ -14,4 +14,14 @@ uint64_t djb2_hash_string(const unsigned char *str);
 */
 uint64_t djb2_hash(const uint8_t *data, size_t size);
 
+/**
+ * @brief mix the bits of a 64 bit value so that every input bit affects every output bit. Use it to spread weak hashes
+*/
+uint64_t mix_hash_u64(uint64_t value);
+
+/**
+ * @brief fast 64 bit hash, reads 8 bytes at a time. Not cryptographic
+*/
+uint64_t mix_hash(const uint8_t *data, size_t size);
+
 #endif
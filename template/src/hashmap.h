@@ -0,0 +1,293 @@
+#ifndef _HASHMAP_HEADER_
+#define _HASHMAP_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Typed hash maps and sets generated by macros. Keys and values are stored inline in one array,
+ * hash and equality are specialized at compile time and no allocation is made per entry.
+ * Sets and counters of integers are already defined in counter.h.
+ * Use 'hashtable_t' from data.h for strings and variable size keys.
+ * @details
+ * static inline uint64_t point_hash(point_t p){ return hashmap_hash_pair(p.y, p.x); }
+ * static inline bool point_eq(point_t a, point_t b){ return a.y == b.y && a.x == b.x; }
+ * HASHMAP_DEFINE(pointmap, point_t, int, point_hash, point_eq)
+ *
+ * pointmap_t *seen = pointmap_new(0);
+ * (*pointmap_put(seen, p, NULL))++;
+ * int *count = pointmap_get(seen, p);
+ * pointmap_destroy(seen);
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// grow when more than this percentage of the slots is used
+#define HASHMAP_MAX_LOAD 75
+
+#define HASHMAP_MIN_CAPACITY 16
+
+// control byte of a free slot, used slots have the high bit set and the top 7 bits of the hash
+#define HASHMAP_CTRL_EMPTY 0
+
+// ------------------------------------------------------------ Hashes -------------------------------------------------------------
+
+/**
+ * @brief hash for integer keys, same mix as 'mix_hash_u64'
+*/
+static inline uint64_t hashmap_hash_u64(uint64_t value){
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ULL;
+	value ^= value >> 33;
+	return value;
+}
+
+/**
+ * @brief hash for keys made of two integers, like points
+*/
+static inline uint64_t hashmap_hash_pair(uint64_t a, uint64_t b){
+	return hashmap_hash_u64(a * 0x9E3779B97F4A7C15ULL ^ b);
+}
+
+/**
+ * @brief equality for scalar keys
+*/
+#define hashmap_eq_scalar(a, b) ((a) == (b))
+
+// ------------------------------------------------------------ Map ----------------------------------------------------------------
+
+/**
+ * @brief shared part of 'HASHMAP_DEFINE' and 'HASHSET_DEFINE', 'name_entry_t' must be defined with a 'key' field
+*/
+#define HASHMAP_DEFINE_COMMON(name, K, hash, eq)																\
+																												\
+typedef struct{																									\
+	uint8_t *ctrl;																								\
+	name##_entry_t *entries;																					\
+	size_t capacity;																							\
+	size_t count;																								\
+}name##_t;																										\
+																												\
+typedef struct name##_ite name##_ite;																			\
+struct name##_ite{																								\
+	name##_entry_t *(*next)(name##_ite *ite);																	\
+	bool yield;																									\
+	const name##_t *m;																							\
+	size_t pos;																									\
+};																												\
+																												\
+static inline uint8_t name##_fingerprint(uint64_t h){															\
+	return 0x80 | (uint8_t)(h >> 57);																			\
+}																												\
+																												\
+static inline void name##_alloc(name##_t *m, size_t capacity){													\
+	m->capacity = capacity;																						\
+	m->count = 0;																								\
+	m->ctrl = calloc(capacity, sizeof(uint8_t));																\
+	m->entries = malloc(capacity * sizeof(name##_entry_t));														\
+}																												\
+																												\
+static inline name##_t *name##_new(size_t size){																\
+	size_t capacity = HASHMAP_MIN_CAPACITY;																		\
+	while(capacity * HASHMAP_MAX_LOAD < size * 100)																\
+		capacity <<= 1;																							\
+																												\
+	name##_t *m = malloc(sizeof(name##_t));																		\
+	name##_alloc(m, capacity);																					\
+	return m;																									\
+}																												\
+																												\
+static inline void name##_destroy(name##_t *m){																	\
+	if(m == NULL) return;																						\
+	free(m->ctrl);																								\
+	free(m->entries);																							\
+	free(m);																									\
+}																												\
+																												\
+static inline void name##_clear(name##_t *m){																	\
+	memset(m->ctrl, HASHMAP_CTRL_EMPTY, m->capacity);															\
+	m->count = 0;																								\
+}																												\
+																												\
+static inline size_t name##_size(const name##_t *m){															\
+	return m->count;																							\
+}																												\
+																												\
+static inline size_t name##_find(const name##_t *m, K key, uint64_t h){											\
+	size_t mask = m->capacity - 1;																				\
+	uint8_t fp = name##_fingerprint(h);																			\
+	for(size_t i = h & mask;; i = (i + 1) & mask){																\
+		uint8_t c = m->ctrl[i];																					\
+		if(c == HASHMAP_CTRL_EMPTY) return SIZE_MAX;															\
+		if(c == fp && eq(m->entries[i].key, key)) return i;														\
+	}																											\
+}																												\
+																												\
+static inline size_t name##_place(name##_t *m, K key, uint64_t h){												\
+	size_t mask = m->capacity - 1;																				\
+	size_t i = h & mask;																						\
+	while(m->ctrl[i] != HASHMAP_CTRL_EMPTY)																		\
+		i = (i + 1) & mask;																						\
+																												\
+	m->ctrl[i] = name##_fingerprint(h);																			\
+	m->entries[i].key = key;																					\
+	m->count++;																									\
+	return i;																									\
+}																												\
+																												\
+static inline void name##_grow(name##_t *m){																	\
+	name##_t old = *m;																							\
+	name##_alloc(m, old.capacity * 2);																			\
+	for(size_t i = 0; i < old.capacity; i++){																	\
+		if(old.ctrl[i] == HASHMAP_CTRL_EMPTY) continue;															\
+		size_t j = name##_place(m, old.entries[i].key, hash(old.entries[i].key));								\
+		m->entries[j] = old.entries[i];																			\
+	}																											\
+	free(old.ctrl);																								\
+	free(old.entries);																							\
+}																												\
+																												\
+/* slot of 'key', inserted when missing */																		\
+static inline size_t name##_insert(name##_t *m, K key, bool *inserted){											\
+	uint64_t h = hash(key);																						\
+	size_t i = name##_find(m, key, h);																			\
+	if(inserted != NULL) *inserted = i == SIZE_MAX;																\
+	if(i != SIZE_MAX) return i;																					\
+																												\
+	if((m->count + 1) * 100 > m->capacity * HASHMAP_MAX_LOAD)													\
+		name##_grow(m);																							\
+	return name##_place(m, key, h);																				\
+}																												\
+																												\
+static inline bool name##_exists(const name##_t *m, K key){														\
+	return name##_find(m, key, hash(key)) != SIZE_MAX;															\
+}																												\
+																												\
+/* backward shift: pull back the following entries that can't be reached with 'i' empty */						\
+static inline void name##_erase(name##_t *m, size_t i){															\
+	size_t mask = m->capacity - 1;																				\
+	for(size_t j = (i + 1) & mask; m->ctrl[j] != HASHMAP_CTRL_EMPTY; j = (j + 1) & mask){						\
+		size_t home = hash(m->entries[j].key) & mask;															\
+		if(((j - home) & mask) < ((j - i) & mask)) continue;													\
+		m->ctrl[i] = m->ctrl[j];																				\
+		m->entries[i] = m->entries[j];																			\
+		i = j;																									\
+	}																											\
+	m->ctrl[i] = HASHMAP_CTRL_EMPTY;																			\
+	m->count--;																									\
+}																												\
+																												\
+static inline name##_entry_t *name##_next(name##_ite *ite){														\
+	while(ite->pos < ite->m->capacity){																			\
+		size_t i = ite->pos++;																					\
+		if(ite->m->ctrl[i] != HASHMAP_CTRL_EMPTY) return &ite->m->entries[i];									\
+	}																											\
+	ite->yield = false;																							\
+	return NULL;																								\
+}																												\
+																												\
+static inline name##_ite name##_iterate(const name##_t *m){														\
+	return (name##_ite){																						\
+		.next = name##_next,																					\
+		.yield = true,																							\
+		.m = m,																									\
+		.pos = 0,																								\
+	};																											\
+}
+
+/**
+ * @brief define the type 'name_t' mapping 'K' to 'V' and it's functions:
+ * - name_t *name_new(size_t size): 'size' is the expected number of entries, 0 for the default
+ * - void name_destroy(name_t *m)
+ * - void name_clear(name_t *m): remove all entries, keeping the memory
+ * - size_t name_size(const name_t *m)
+ * - V *name_get(const name_t *m, K key): pointer to the value or NULL
+ * - bool name_exists(const name_t *m, K key)
+ * - V *name_put(name_t *m, K key, bool *inserted): pointer to the value, a zeroed one is inserted when 'key' is missing.
+ * 'inserted' can be NULL
+ * - void name_set(name_t *m, K key, V value)
+ * - bool name_remove(name_t *m, K key, V *value): the removed value is copied to 'value' when not NULL
+ * - name_ite name_iterate(const name_t *m): iterate through the entries (name_entry_t*) in no particular order
+ *
+ * Pointers returned by 'get' and 'put' and running iterators are invalidated by 'put', 'set' and 'remove'
+ * @param name: prefix of the generated types and functions
+ * @param hash: function or macro taking a 'K' and returning an uint64_t. The low bits pick the slot and the high ones
+ * are kept as a fingerprint, so it should mix well ('hashmap_hash_u64')
+ * @param eq: function or macro taking two 'K' and returning true when they are equal
+*/
+#define HASHMAP_DEFINE(name, K, V, hash, eq)																	\
+																												\
+typedef struct{																									\
+	K key;																										\
+	V value;																									\
+}name##_entry_t;																								\
+																												\
+HASHMAP_DEFINE_COMMON(name, K, hash, eq)																		\
+																												\
+static inline V *name##_get(const name##_t *m, K key){															\
+	size_t i = name##_find(m, key, hash(key));																	\
+	return i != SIZE_MAX ? &m->entries[i].value : NULL;															\
+}																												\
+																												\
+static inline V *name##_put(name##_t *m, K key, bool *inserted){												\
+	bool added;																									\
+	size_t i = name##_insert(m, key, &added);																	\
+	if(added)																									\
+		memset(&m->entries[i].value, 0, sizeof(V));																\
+	if(inserted != NULL) *inserted = added;																		\
+	return &m->entries[i].value;																				\
+}																												\
+																												\
+static inline void name##_set(name##_t *m, K key, V value){														\
+	*name##_put(m, key, NULL) = value;																			\
+}																												\
+																												\
+static inline bool name##_remove(name##_t *m, K key, V *value){													\
+	size_t i = name##_find(m, key, hash(key));																	\
+	if(i == SIZE_MAX) return false;																				\
+	if(value != NULL) *value = m->entries[i].value;																\
+	name##_erase(m, i);																							\
+	return true;																								\
+}
+
+// ------------------------------------------------------------ Set ----------------------------------------------------------------
+
+/**
+ * @brief define the type 'name_t', a set of 'K', and it's functions:
+ * - name_t *name_new(size_t size): 'size' is the expected number of keys, 0 for the default
+ * - void name_destroy(name_t *s)
+ * - void name_clear(name_t *s)
+ * - size_t name_size(const name_t *s)
+ * - bool name_add(name_t *s, K key): true if it wasn't in
+ * - bool name_exists(const name_t *s, K key)
+ * - bool name_remove(name_t *s, K key): true if it was in
+ * - name_ite name_iterate(const name_t *s): iterate through the keys (name_entry_t*) in no particular order
+ *
+ * Only keys are stored, with the same layout and probing as 'HASHMAP_DEFINE'
+*/
+#define HASHSET_DEFINE(name, K, hash, eq)																		\
+																												\
+typedef struct{																									\
+	K key;																										\
+}name##_entry_t;																								\
+																												\
+HASHMAP_DEFINE_COMMON(name, K, hash, eq)																		\
+																												\
+static inline bool name##_add(name##_t *s, K key){																\
+	bool added;																									\
+	name##_insert(s, key, &added);																				\
+	return added;																								\
+}																												\
+																												\
+static inline bool name##_remove(name##_t *s, K key){															\
+	size_t i = name##_find(s, key, hash(key));																	\
+	if(i == SIZE_MAX) return false;																				\
+	name##_erase(s, i);																							\
+	return true;																								\
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "heap.h"
+
+// ------------------------------------------------------------ Heap ---------------------------------------------------------------
+
+// !trivial
+heap_t *heap_new_custom(bool takeOwnership, cmpFunc priorityCmp, bool indexed){
+	heap_t *h = calloc(1, sizeof(heap_t));
+	h->onws = takeOwnership;
+	h->cmpFunc = priorityCmp;
+	h->indexed = indexed;
+	h->capacity = HEAP_MIN_CAPACITY;
+	h->entries = malloc(h->capacity * sizeof(heap_entry_t));
+	return h;
+}
+
+heap_t *heap_new(cmpFunc priorityCmp){
+	return heap_new_custom(false, priorityCmp, false);
+}
+
+// !trivial
+void heap_destroy(heap_t *h){
+	if(h == NULL) return;
+
+	if(h->onws){
+		for(size_t i = 0; i < h->size; i++){
+			free(h->entries[i].value);
+		}
+	}
+
+	free(h->entries);
+	free(h->positions);
+	free(h->freeHandles);
+	free(h);
+}
+
+size_t heap_size(const heap_t *h){
+	return h->size;
+}
+
+// true if 'a' should be popped before 'b'
+static inline bool heap_before(const heap_t *h, void *a, void *b){
+	return h->cmpFunc(b, a) == cmp_left;
+}
+
+static inline void heap_place(heap_t *h, size_t pos, heap_entry_t entry){
+	h->entries[pos] = entry;
+	if(h->indexed)
+		h->positions[entry.handle] = pos;
+}
+
+// !trivial
+// move the entry at 'pos' up while it goes before it's parent, moving the hole instead of swapping
+static void heap_sift_up(heap_t *h, size_t pos){
+	heap_entry_t entry = h->entries[pos];
+	while(pos > 0){
+		size_t parent = (pos - 1) / HEAP_ARITY;
+		if(!heap_before(h, entry.value, h->entries[parent].value)) break;
+
+		heap_place(h, pos, h->entries[parent]);
+		pos = parent;
+	}
+	heap_place(h, pos, entry);
+}
+
+// !trivial
+// move the entry at 'pos' down while one of it's children goes before it
+static void heap_sift_down(heap_t *h, size_t pos){
+	heap_entry_t entry = h->entries[pos];
+	for(;;){
+		size_t first = pos * HEAP_ARITY + 1;
+		if(first >= h->size) break;
+
+		size_t last = first + HEAP_ARITY < h->size ? first + HEAP_ARITY : h->size;
+		size_t best = first;
+		for(size_t child = first + 1; child < last; child++){
+			if(heap_before(h, h->entries[child].value, h->entries[best].value))
+				best = child;
+		}
+
+		if(!heap_before(h, h->entries[best].value, entry.value)) break;
+
+		heap_place(h, pos, h->entries[best]);
+		pos = best;
+	}
+	heap_place(h, pos, entry);
+}
+
+// !trivial
+static heap_handle_t heap_handle_new(heap_t *h){
+	if(h->freeSize > 0)
+		return h->freeHandles[--h->freeSize];
+
+	// 'freeHandles' never holds more than 'handles' entries, grow it along 'positions'
+	if(h->handles == h->handlesCapacity){
+		h->handlesCapacity = h->handlesCapacity > 0 ? h->handlesCapacity * 2 : HEAP_MIN_CAPACITY;
+		h->positions = realloc(h->positions, h->handlesCapacity * sizeof(size_t));
+		h->freeHandles = realloc(h->freeHandles, h->handlesCapacity * sizeof(heap_handle_t));
+	}
+
+	return h->handles++;
+}
+
+// !trivial
+static void heap_handle_free(heap_t *h, heap_handle_t handle){
+	h->positions[handle] = SIZE_MAX;
+	h->freeHandles[h->freeSize++] = handle;
+}
+
+// !trivial
+heap_handle_t heap_push(heap_t *h, void *value){
+	if(h->size == h->capacity){
+		h->capacity *= 2;
+		h->entries = realloc(h->entries, h->capacity * sizeof(heap_entry_t));
+	}
+
+	heap_entry_t entry = {.value = value, .handle = HEAP_NO_HANDLE};
+	if(h->indexed)
+		entry.handle = heap_handle_new(h);
+
+	h->entries[h->size] = entry;
+	heap_sift_up(h, h->size++);
+	return entry.handle;
+}
+
+// !trivial
+// remove the entry at 'pos', filling the gap with the last one
+static void *heap_remove_at(heap_t *h, size_t pos){
+	heap_entry_t entry = h->entries[pos];
+	if(h->indexed)
+		heap_handle_free(h, entry.handle);
+
+	if(--h->size > pos){
+		heap_place(h, pos, h->entries[h->size]);
+		heap_sift_down(h, pos);
+		heap_sift_up(h, pos);
+	}
+
+	return entry.value;
+}
+
+void *heap_pop(heap_t *h){
+	if(h == NULL || h->size == 0) return NULL;
+	return heap_remove_at(h, 0);
+}
+
+void *heap_peek(const heap_t *h){
+	if(h == NULL || h->size == 0) return NULL;
+	return h->entries[0].value;
+}
+
+bool heap_contains(const heap_t *h, heap_handle_t handle){
+	return h->indexed && handle < h->handles && h->positions[handle] != SIZE_MAX;
+}
+
+// !trivial
+bool heap_update(heap_t *h, heap_handle_t handle){
+	if(!heap_contains(h, handle)) return false;
+
+	size_t pos = h->positions[handle];
+	heap_sift_up(h, pos);
+	heap_sift_down(h, h->positions[handle]);
+	return true;
+}
+
+void *heap_remove(heap_t *h, heap_handle_t handle){
+	if(!heap_contains(h, handle)) return NULL;
+	return heap_remove_at(h, h->positions[handle]);
+}
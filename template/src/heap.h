@@ -0,0 +1,124 @@
+#ifndef _HEAP_HEADER_
+#define _HEAP_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data.h"
+
+/**
+ * @file Array backed d-ary heap, a priority queue with O(log n) push and pop.
+ * Priority is decided by the same 'cmpFunc' used by 'list_new_custom_queue', the element that would be put
+ * more to the left of a priority queue is popped first.
+ * Heaps created as indexed hand out a handle on push, which can be used to change the priority of an element that is
+ * already in (decrease-key) or to remove it.
+ * @details
+ * heap_t *open = heap_new_custom(false, cmpCost, true);
+ * heap_handle_t handles[h][w];
+ * handles[y][x] = heap_push(open, node);
+ * ...
+ * node->cost = cost;
+ * heap_update(open, handles[y][x]);
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// children per node, 4 keeps the tree shallow while the children of a node share a cache line
+#define HEAP_ARITY 4
+
+#define HEAP_MIN_CAPACITY 64
+
+// handle returned by heaps that are not indexed
+#define HEAP_NO_HANDLE SIZE_MAX
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef size_t heap_handle_t;
+
+typedef struct{
+	void *value;
+	heap_handle_t handle;
+}heap_entry_t;
+
+typedef struct{
+	heap_entry_t *entries;
+	size_t size;
+	size_t capacity;
+	cmpFunc cmpFunc;
+	bool onws;
+	bool indexed;
+	size_t *positions;										/**< position in 'entries' of each handle, SIZE_MAX if not in the heap */
+	size_t handles;											/**< handles given so far */
+	size_t handlesCapacity;
+	heap_handle_t *freeHandles;								/**< handles of popped elements, reused by the next pushes */
+	size_t freeSize;
+}heap_t;
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief creates a new heap, not indexed.
+ * Values in the heap are NOT freed when 'heap_destroy' is called
+ * @param priorityCmp: same as 'list_new_custom_queue'. Called as (already present, other), 'cmp_left' means 'other'
+ * has priority. Any other result means it hasn't, 'cmp_reject' doesn't reject anything
+*/
+heap_t *heap_new(cmpFunc priorityCmp);
+
+/**
+ * @brief creates a new heap
+ * @param takeOwnership: true if pushed values should be freed along with the heap deallocation
+ * @param priorityCmp: same as 'heap_new'
+ * @param indexed: true to keep handles, needed by 'heap_update' and 'heap_remove'
+*/
+heap_t *heap_new_custom(bool takeOwnership, cmpFunc priorityCmp, bool indexed);
+
+/**
+ * @brief destroys a heap. If it was created with 'takeOwnership' as true, then values inside will be deallocated alongside the heap
+*/
+void heap_destroy(heap_t *h);
+
+/**
+ * @brief get heap size
+*/
+size_t heap_size(const heap_t *h);
+
+/**
+ * @brief pushes a value to the heap
+ * @return the handle of the value, valid until it leaves the heap. 'HEAP_NO_HANDLE' if the heap is not indexed
+ * @attention O(log n)
+*/
+heap_handle_t heap_push(heap_t *h, void *value);
+
+/**
+ * @brief removes and returns the value with the highest priority, NULL if empty
+ * @attention O(log n)
+*/
+void *heap_pop(heap_t *h);
+
+/**
+ * @brief returns the value with the highest priority without removing it, NULL if empty
+ * @attention O(1)
+*/
+void *heap_peek(const heap_t *h);
+
+/**
+ * @brief check if the value of a handle is still in the heap
+ * @attention O(1)
+*/
+bool heap_contains(const heap_t *h, heap_handle_t handle);
+
+/**
+ * @brief restore the order after the priority of the value of 'handle' changed, up or down. Only for indexed heaps
+ * @return false if the handle is not in the heap
+ * @attention O(log n)
+*/
+bool heap_update(heap_t *h, heap_handle_t handle);
+
+/**
+ * @brief removes and returns the value of a handle, NULL if it's not in the heap. Only for indexed heaps
+ * @attention O(log n)
+*/
+void *heap_remove(heap_t *h, heap_handle_t handle);
+
+#endif
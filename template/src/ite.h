@@ -9,7 +9,7 @@
 // 	ite_next_func next;
 // };
 
-#define foreach(type, var, ite) for(type var = ite.next(&ite); ite.yield; var = ite.next(&ite))
+#define foreach(type, var, ite) for(type var = next(ite); ite.yield; var = next(ite))
 
 #define next(ite) ite.next(&ite)
 
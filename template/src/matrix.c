@@ -8,6 +8,7 @@ matrix_t *matrix_new(size_t w, size_t h, int init){
 	matrix_t *m = malloc(sizeof(matrix_t));
 	m->w = w;
 	m->h = h;
+	m->arena = NULL;
 	m->rows = malloc(sizeof(int*) * h);
 	
 	for(size_t i = 0; i < h; i++){
@@ -20,25 +21,45 @@ matrix_t *matrix_new(size_t w, size_t h, int init){
 	return m;
 }
 
+matrix_t *matrix_new_arena(arena_t *arena, size_t w, size_t h, int init){
+	if(!w && !h) return NULL;
+
+	matrix_t *m = arena_alloc(arena, sizeof(matrix_t));
+	m->w = w;
+	m->h = h;
+	m->arena = arena;
+	m->rows = arena_alloc(arena, sizeof(int*) * h);
+
+	int *cells = arena_alloc(arena, sizeof(int) * w * h);
+	for(size_t i = 0; i < w * h; i++)
+		cells[i] = init;
+
+	for(size_t i = 0; i < h; i++)
+		m->rows[i] = cells + i * w;
+
+	return m;
+}
+
+// !trivial
 matrix_t *matrix_from_string(const string *lines){
-	// compute how many lines
-	size_t h = 1;
-	for(char *i = lines->raw; *i != '\0'; i++){
-		if(*i == '\n')
-			h++;
-	}
+	string_lines_t index = string_lines_index(lines);
 
 	matrix_t *m = malloc(sizeof(matrix_t));
-	m->rows = malloc(sizeof(int*) * h);
+	m->arena = NULL;
+	m->rows = malloc(sizeof(int*) * (index.count > 0 ? index.count : 1));
+	m->w = 0;
 
+	// empty lines are skipped, shorter lines are padded with 0
 	size_t l = 0;
-	string_ite ite = string_split(lines, "\n");
-	for(string line = ite.next(&ite); ite.yield; line = ite.next(&ite)){
+	for(size_t i = 0; i < index.count; i++){
+		string line = string_lines_at(&index, i);
+		if(line.len == 0) continue;
+
 		if(l == 0)
 			m->w = line.len;
 
-		m->rows[l] = malloc(sizeof(int) * m->w);
-		for(size_t c = 0; c < m->w; c++)
+		m->rows[l] = calloc(m->w, sizeof(int));
+		for(size_t c = 0; c < m->w && c < line.len; c++)
 			m->rows[l][c] = line.raw[c];
 		
 		l++;
@@ -46,6 +67,7 @@ matrix_t *matrix_from_string(const string *lines){
 
 	m->h = l;
 
+	string_lines_destroy(&index);
 	return m;
 }
 
@@ -59,7 +81,7 @@ matrix_t *matrix_from_file(FILE *file, size_t *read){
 }
 
 matrix_t *matrix_from_filename(const char *filename, size_t *read){
-	string *f = string_from_filename(filename, read);
+	string *f = string_map_filename(filename, read, string_map_sequential);
 	if(f == NULL) return NULL;
 
 	matrix_t *m = matrix_from_string(f);
@@ -77,6 +99,9 @@ matrix_t *matrix_copy(const matrix_t *m){
 }
 
 void matrix_destroy(matrix_t *m){
+	// released with the arena
+	if(m->arena != NULL) return;
+
 	for(size_t i = 0; i < m->h; i++)
 		free(m->rows[i]);
 
@@ -214,24 +239,23 @@ dmatrix_t *dmatrix_new_identity(size_t w, size_t h){
 
 // !trivial
 dmatrix_t *dmatrix_from_string(const string *lines){
-	// compute how many lines
-	size_t h = 1;
-	for(char *i = lines->raw; *i != '\0'; i++){
-		if(*i == '\n')
-			h++;
-	}
+	string_lines_t index = string_lines_index(lines);
 
 	dmatrix_t *m = malloc(sizeof(dmatrix_t));
-	m->rows = malloc(sizeof(double*) * h);
+	m->rows = malloc(sizeof(double*) * (index.count > 0 ? index.count : 1));
+	m->w = 0;
 
+	// empty lines are skipped, shorter lines are padded with 0
 	size_t l = 0;
-	string_ite ite = string_split(lines, "\n");
-	for(string line = ite.next(&ite); ite.yield; line = ite.next(&ite)){
+	for(size_t i = 0; i < index.count; i++){
+		string line = string_lines_at(&index, i);
+		if(line.len == 0) continue;
+
 		if(l == 0)
 			m->w = line.len;
 
-		m->rows[l] = malloc(sizeof(double) * m->w);
-		for(size_t c = 0; c < m->w; c++)
+		m->rows[l] = calloc(m->w, sizeof(double));
+		for(size_t c = 0; c < m->w && c < line.len; c++)
 			m->rows[l][c] = line.raw[c];
 		
 		l++;
@@ -239,6 +263,7 @@ dmatrix_t *dmatrix_from_string(const string *lines){
 
 	m->h = l;
 
+	string_lines_destroy(&index);
 	return m;
 }
 
@@ -251,7 +276,7 @@ dmatrix_t *dmatrix_from_file(FILE *file, size_t *read){
 }
 
 dmatrix_t *dmatrix_from_filename(const char *filename, size_t *read){
-	string *f = string_from_filename(filename, read);
+	string *f = string_map_filename(filename, read, string_map_sequential);
 	if(f == NULL) return NULL;
 	dmatrix_t *m = dmatrix_from_string(f);
 	string_destroy(f);
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include "data.h"
 #include "string+.h"
+#include "hashmap.h"
 
 // ------------------------------------------------------------ Matrix -------------------------------------------------------------
 
@@ -12,6 +13,7 @@ typedef struct{
 	size_t w;
 	size_t h;
 	int **rows;
+	arena_t *arena;											/**< rows are allocated from it when not NULL */
 }matrix_t;
 
 typedef struct{
@@ -19,8 +21,25 @@ typedef struct{
 	size_t x;
 }point_t;
 
+/**
+ * @brief hash and equality of points, to key typed hash maps: HASHMAP_DEFINE(pointmap, point_t, int, point_hash, point_eq)
+*/
+static inline uint64_t point_hash(point_t p){
+	return hashmap_hash_pair(p.y, p.x);
+}
+
+static inline bool point_eq(point_t a, point_t b){
+	return a.y == b.y && a.x == b.x;
+}
+
 matrix_t *matrix_new(size_t w, size_t h, int init);
 
+/**
+ * @brief create a matrix allocated from an arena, rows are contiguous in memory.
+ * 'matrix_destroy' doesn't free anything, the memory is released with the arena
+*/
+matrix_t *matrix_new_arena(arena_t *arena, size_t w, size_t h, int init);
+
 matrix_t *matrix_from_string(const string *lines);
 
 matrix_t *matrix_from_file(FILE *file, size_t *read);
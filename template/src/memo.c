@@ -0,0 +1,141 @@
+#include "memo.h"
+#include "hash.h"
+
+// ------------------------------------------------------------ Memo ---------------------------------------------------------------
+
+static inline size_t memo_align(size_t size){
+	return (size + 7) & ~(size_t)7;
+}
+
+static inline uint8_t *memo_entry(const memo_t *m, size_t i){
+	return m->data + i * m->stride;
+}
+
+// !trivial
+memo_t *memo_new(size_t keySize, size_t valueSize, size_t capacity){
+	memo_t *m = calloc(1, sizeof(memo_t));
+	m->keySize = keySize;
+	m->valueSize = valueSize;
+	m->valueOffset = memo_align(keySize);
+	m->stride = m->valueOffset + memo_align(valueSize);
+	m->capacity = capacity > 0 ? capacity : 1;
+
+	// at most half full, probes stay short
+	size_t indexCapacity = 16;
+	while(indexCapacity < m->capacity * 2)
+		indexCapacity <<= 1;
+	m->indexMask = indexCapacity - 1;
+
+	m->data = malloc(m->capacity * m->stride);
+	m->hashes = malloc(m->capacity * sizeof(uint64_t));
+	m->referenced = calloc(m->capacity, sizeof(uint8_t));
+	m->index = calloc(indexCapacity, sizeof(uint32_t));
+	return m;
+}
+
+void memo_destroy(memo_t *m){
+	if(m == NULL) return;
+	free(m->data);
+	free(m->hashes);
+	free(m->referenced);
+	free(m->index);
+	free(m);
+}
+
+// !trivial
+void memo_clear(memo_t *m){
+	memset(m->index, 0, (m->indexMask + 1) * sizeof(uint32_t));
+	memset(m->referenced, 0, m->capacity);
+	m->size = 0;
+	m->hand = 0;
+	m->stats = (memo_stats_t){0};
+}
+
+size_t memo_size(const memo_t *m){
+	return m->size;
+}
+
+memo_stats_t memo_stats(const memo_t *m){
+	return m->stats;
+}
+
+// !trivial
+// slot of the index holding 'key', or the empty slot ending it's probe sequence
+static size_t memo_find(const memo_t *m, const void *key, uint64_t hash){
+	for(size_t i = hash & m->indexMask;; i = (i + 1) & m->indexMask){
+		uint32_t e = m->index[i];
+		if(e == 0) return i;
+		if(m->hashes[e - 1] == hash && !memcmp(memo_entry(m, e - 1), key, m->keySize)) return i;
+	}
+}
+
+// !trivial
+// backward shift: pull back the following slots that can't be reached with 'i' empty
+static void memo_unindex(memo_t *m, size_t i){
+	for(size_t j = (i + 1) & m->indexMask; m->index[j] != 0; j = (j + 1) & m->indexMask){
+		size_t home = m->hashes[m->index[j] - 1] & m->indexMask;
+		if(((j - home) & m->indexMask) < ((j - i) & m->indexMask)) continue;
+		m->index[i] = m->index[j];
+		i = j;
+	}
+	m->index[i] = 0;
+}
+
+// !trivial
+// CLOCK: sweep clearing the referenced bits until an entry without one is found
+static size_t memo_evict(memo_t *m){
+	while(m->referenced[m->hand]){
+		m->referenced[m->hand] = 0;
+		m->hand = (m->hand + 1) % m->capacity;
+	}
+
+	size_t victim = m->hand;
+	m->hand = (m->hand + 1) % m->capacity;
+
+	const uint8_t *key = memo_entry(m, victim);
+	memo_unindex(m, memo_find(m, key, m->hashes[victim]));
+	m->stats.evictions++;
+	return victim;
+}
+
+// !trivial
+void *memo_get(memo_t *m, const void *key){
+	uint64_t hash = mix_hash(key, m->keySize);
+	uint32_t e = m->index[memo_find(m, key, hash)];
+	if(e == 0){
+		m->stats.misses++;
+		return NULL;
+	}
+
+	m->stats.hits++;
+	m->referenced[e - 1] = 1;
+	return memo_entry(m, e - 1) + m->valueOffset;
+}
+
+// !trivial
+void *memo_put(memo_t *m, const void *key, const void *value){
+	uint64_t hash = mix_hash(key, m->keySize);
+	size_t slot = memo_find(m, key, hash);
+	size_t e;
+	if(m->index[slot] != 0){
+		e = m->index[slot] - 1;
+	}else{
+		if(m->size < m->capacity){
+			e = m->size++;
+		}else{
+			e = memo_evict(m);
+			// the eviction may have shifted the slot
+			slot = memo_find(m, key, hash);
+		}
+
+		// new entries start unreferenced, a key used once is the first to go
+		m->referenced[e] = 0;
+		m->hashes[e] = hash;
+		m->index[slot] = e + 1;
+		memcpy(memo_entry(m, e), key, m->keySize);
+	}
+
+	uint8_t *dest = memo_entry(m, e) + m->valueOffset;
+	memcpy(dest, value, m->valueSize);
+	return dest;
+}
@@ -0,0 +1,110 @@
+#ifndef _MEMO_HEADER_
+#define _MEMO_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Bounded memoization cache. Keys and values have a fixed size and are copied inline in one array,
+ * when the cache is full the CLOCK algorithm evicts an entry that wasn't used since the hand last passed,
+ * so memory stays bounded and the entries recursions keep coming back to stay in.
+ * Keys are compared byte by byte, so they must not have padding: pack them in integers or in structs of same size fields.
+ * @details
+ * MEMO_FUNCTION(count_ways, uint64_t, uint64_t, 1 << 16){
+ * 	 if(key == 0) return 1;
+ * 	 return count_ways(key - 1) + (key >= 2 ? count_ways(key - 2) : 0);
+ * }
+ *
+ * uint64_t ways = count_ways(80);
+ * count_ways_reset();
+*/
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef struct{
+	uint64_t hits;
+	uint64_t misses;										/**< lookups of a key not in the cache */
+	uint64_t evictions;										/**< entries dropped to make room */
+}memo_stats_t;
+
+typedef struct{
+	uint8_t *data;											/**< entries, key then value, 'stride' bytes each */
+	uint64_t *hashes;										/**< hash of each entry, to move them in the index without hashing again */
+	uint8_t *referenced;									/**< CLOCK bit of each entry, set on every hit */
+	uint32_t *index;										/**< open addressing table of entry + 1, 0 if empty */
+	size_t indexMask;
+	size_t keySize;
+	size_t valueSize;
+	size_t valueOffset;										/**< offset of the value in an entry */
+	size_t stride;
+	size_t capacity;										/**< maximum number of entries */
+	size_t size;
+	size_t hand;											/**< CLOCK hand, next entry considered for eviction */
+	memo_stats_t stats;
+}memo_t;
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief creates a cache of at most 'capacity' entries of 'keySize' bytes keys and 'valueSize' bytes values.
+ * All the memory is allocated here
+*/
+memo_t *memo_new(size_t keySize, size_t valueSize, size_t capacity);
+
+void memo_destroy(memo_t *m);
+
+/**
+ * @brief remove all entries and reset the counters, keeping the memory
+*/
+void memo_clear(memo_t *m);
+
+size_t memo_size(const memo_t *m);
+
+memo_stats_t memo_stats(const memo_t *m);
+
+/**
+ * @brief get the value of a key
+ * @return pointer to the value, valid until the next 'memo_put', or NULL if not cached
+ * @attention Avg: O(1)
+*/
+void *memo_get(memo_t *m, const void *key);
+
+/**
+ * @brief cache a value, replacing the one already there. Evicts an entry when full
+ * @return pointer to the cached value, valid until the next 'memo_put'
+ * @attention Avg: O(1)
+*/
+void *memo_put(memo_t *m, const void *key, const void *value);
+
+// ------------------------------------------------------------ Helper -------------------------------------------------------------
+
+/**
+ * @brief define 'R name(K key)' memoized by a cache of 'capacity' entries, followed by it's body.
+ * The body can call 'name' recursively. Also defines 'void name_reset(void)', clearing the cache,
+ * and 'memo_t *name_memo', created on the first call. 'K' must not have padding
+*/
+#define MEMO_FUNCTION(name, R, K, capacity)																		\
+																												\
+static memo_t *name##_memo = NULL;																				\
+																												\
+static inline void name##_reset(void){																			\
+	if(name##_memo != NULL) memo_clear(name##_memo);															\
+}																												\
+																												\
+static R name##_compute(K key);																					\
+																												\
+static R name(K key){																							\
+	if(name##_memo == NULL)																						\
+		name##_memo = memo_new(sizeof(K), sizeof(R), (capacity));												\
+	R *cached = memo_get(name##_memo, &key);																	\
+	if(cached != NULL) return *cached;																			\
+	R value = name##_compute(key);																				\
+	memo_put(name##_memo, &key, &value);																		\
+	return value;																								\
+}																												\
+																												\
+static R name##_compute(K key)
+
+#endif
@@ -302,7 +302,8 @@ int orderMultiples(const void *A, const void *B){
 	const uint64_t *a = (const uint64_t*)A;
 	const uint64_t *b = (const uint64_t*)B;
 
-	return *a - *b;
+	// the difference of two uint64_t doesn't fit in an int
+	return (*a > *b) - (*a < *b);
 }
 
 // primes up to 10000. See "Sieve of Eratosthenes" later
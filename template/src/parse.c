@@ -0,0 +1,85 @@
+#include "parse.h"
+#include "worker.h"
+#include "ite.h"
+#include <unistd.h>
+
+typedef struct{
+	string chunk;
+	parse_line_func_t f;
+	void *context;
+	array_t *out;
+}parse_chunk_t;
+
+static void *parse_chunk(void *data){
+	parse_chunk_t *chunk = (parse_chunk_t*)data;
+
+	string_ite ite = string_split(&chunk->chunk, "\n");
+	for(string line = next(ite); yield(ite); line = next(ite))
+		chunk->f(&line, chunk->out, chunk->context);
+
+	return NULL;
+}
+
+// !trivial
+array_t *parse_lines_parallel(const string *data, size_t threads, parse_line_func_t f, void *context){
+	if(data == NULL || f == NULL) return NULL;
+
+	if(threads == 0){
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cpus > 0 ? (size_t)cpus : 1;
+	}
+
+	size_t maxChunks = data->len / PARSE_MIN_CHUNK_SIZE;
+	if(threads > maxChunks) threads = maxChunks > 0 ? maxChunks : 1;
+
+	// cut the input in line aligned chunks of about the same size
+	parse_chunk_t chunks[threads];
+	size_t count = 0;
+	const char *cursor = data->raw;
+	const char *end = data->raw + data->len;
+	for(size_t i = 0; i < threads && cursor < end; i++){
+		const char *chunkEnd = i == threads - 1 ? end : data->raw + data->len / threads * (i + 1);
+		if(chunkEnd < cursor) chunkEnd = cursor;
+
+		if(chunkEnd < end){
+			chunkEnd = memchr(chunkEnd, '\n', end - chunkEnd);
+			chunkEnd = chunkEnd != NULL ? chunkEnd + 1 : end;
+		}
+
+		chunks[count++] = (parse_chunk_t){
+			.chunk = (string){.raw = (char*)cursor, .len = chunkEnd - cursor, .allocated = 0, .owns = false},
+			.f = f,
+			.context = context,
+			// arrays grow linearly, start them near the expected number of lines
+			.out = array_new_custom(false, MIN_ARRAY_BLOCK_SIZE + (chunkEnd - cursor) / PARSE_EXPECTED_LINE_SIZE)
+		};
+
+		cursor = chunkEnd;
+	}
+
+	// the first chunk runs on the calling thread
+	worker_t *workers[count > 0 ? count : 1];
+	for(size_t i = 1; i < count; i++)
+		workers[i] = workerCreate(parse_chunk, &chunks[i]);
+
+	if(count > 0)
+		parse_chunk(&chunks[0]);
+
+	for(size_t i = 1; i < count; i++)
+		workerWait(workers[i]);
+
+	// merge in input order
+	size_t total = 0;
+	for(size_t i = 0; i < count; i++)
+		total += array_size(chunks[i].out);
+
+	array_t *ret = array_new_custom(false, total > 0 ? total : MIN_ARRAY_BLOCK_SIZE);
+	for(size_t i = 0; i < count; i++){
+		for(size_t j = 0; j < array_size(chunks[i].out); j++)
+			array_add(ret, array_get(chunks[i].out, j));
+
+		array_destroy(chunks[i].out);
+	}
+
+	return ret;
+}
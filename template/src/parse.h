@@ -0,0 +1,55 @@
+#ifndef _PARSE_HEADER_
+#define _PARSE_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "string+.h"
+#include "data.h"
+
+/**
+ * @file Parallel input parsing. The input is cut into line aligned chunks that are parsed by worker threads,
+ * the results of each chunk are then merged in input order, so the output is the same as a single threaded parse.
+ * Don't forget to link against '-lpthread'
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// minimum size of a chunk, smaller inputs use less threads
+#define PARSE_MIN_CHUNK_SIZE (64 * 1024)
+
+// guess of the average line size, used to size the per chunk result arrays up front
+#define PARSE_EXPECTED_LINE_SIZE 32
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+/**
+ * @brief called once for every line of the input, from the worker threads.
+ * Lines of the same chunk are parsed in order by the same thread, different chunks run at the same time
+ * @param line: a slice of the input, without the '\n'
+ * @param out: push parsed values into it with 'array_add', any number of them per line
+ * @param context: the context given to 'parse_lines_parallel', shared by all threads
+*/
+typedef void (*parse_line_func_t)(const string *line, array_t *out, void *context);
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief parse 'data' line by line in parallel. Lines are split like 'string_split(data, "\n")', so empty lines are skipped
+ * @param data: the input
+ * @param threads: number of worker threads. Pass 0 to use one per online cpu
+ * @param f: line callback
+ * @param context: passed to 'f', must be thread safe if 'f' writes to it
+ * @return array of the values pushed by 'f', in input order. The array doesn't own them, free it with 'array_destroy'
+ * @details
+ * void parseLine(const string *line, array_t *out, void *context){
+ * 		int64_t *n = malloc(sizeof(int64_t));
+ * 		*n = string_to_int(line, 10);
+ * 		array_add(out, n);
+ * }
+ * 
+ * array_t *numbers = parse_lines_parallel(data, 0, parseLine, NULL);
+*/
+array_t *parse_lines_parallel(const string *data, size_t threads, parse_line_func_t f, void *context);
+
+#endif
@@ -0,0 +1,79 @@
+#include "pool.h"
+
+// ------------------------------------------------------------ Pool ---------------------------------------------------------------
+
+// !trivial
+pool_t *pool_new_custom(size_t objectSize, size_t slabObjects){
+	pool_t *p = calloc(1, sizeof(pool_t));
+
+	// room for the freelist link and aligned like malloc
+	if(objectSize < sizeof(pool_free_t))
+		objectSize = sizeof(pool_free_t);
+	p->objectSize = (objectSize + 15) & ~(size_t)15;
+	p->slabObjects = slabObjects > 0 ? slabObjects : POOL_SLAB_OBJECTS;
+	return p;
+}
+
+pool_t *pool_new(size_t objectSize){
+	return pool_new_custom(objectSize, POOL_SLAB_OBJECTS);
+}
+
+void pool_destroy(pool_t *p){
+	if(p == NULL) return;
+
+	pool_slab_t *slab = p->slab;
+	while(slab != NULL){
+		pool_slab_t *prev = slab->prev;
+		free(slab);
+		slab = prev;
+	}
+
+	free(p);
+}
+
+// !trivial
+void *pool_alloc(pool_t *p){
+	p->live++;
+
+	if(p->freeList != NULL){
+		pool_free_t *object = p->freeList;
+		p->freeList = object->next;
+		return object;
+	}
+
+	if(p->slab == NULL || p->slabUsed == p->slabObjects){
+		pool_slab_t *slab = malloc(sizeof(pool_slab_t) + p->slabObjects * p->objectSize);
+		if(slab == NULL){
+			p->live--;
+			return NULL;
+		}
+
+		slab->prev = p->slab;
+		p->slab = slab;
+		p->slabUsed = 0;
+	}
+
+	return p->slab->data + p->objectSize * p->slabUsed++;
+}
+
+void *pool_calloc(pool_t *p){
+	void *ptr = pool_alloc(p);
+	if(ptr != NULL)
+		memset(ptr, 0, p->objectSize);
+
+	return ptr;
+}
+
+// !trivial
+void pool_free(pool_t *p, void *ptr){
+	if(ptr == NULL) return;
+
+	pool_free_t *object = ptr;
+	object->next = p->freeList;
+	p->freeList = object;
+	p->live--;
+}
+
+size_t pool_live(const pool_t *p){
+	return p->live;
+}
@@ -0,0 +1,85 @@
+#ifndef _POOL_HEADER_
+#define _POOL_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Fixed size object pool. Objects are carved from slabs and freed objects are kept in a freelist
+ * for the next allocation, so a structure that keeps pushing and popping, like a BFS queue,
+ * stops calling malloc once it reached it's biggest size. Slabs are only given back by 'pool_destroy'.
+ * Lists created with 'list_new_pooled' and dictionaries allocate their nodes from pools
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// default number of objects per slab
+#define POOL_SLAB_OBJECTS 256
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef struct pool_slab_t pool_slab_t;
+struct pool_slab_t{
+	pool_slab_t *prev;
+	_Alignas(16) uint8_t data[];
+};
+
+typedef struct pool_free_t pool_free_t;
+struct pool_free_t{
+	pool_free_t *next;
+};
+
+typedef struct{
+	size_t objectSize;
+	size_t slabObjects;
+	pool_slab_t *slab;										/**< current slab, older ones are linked through 'prev' */
+	size_t slabUsed;										/**< objects handed out from the current slab */
+	pool_free_t *freeList;									/**< freed objects, reused first */
+	size_t live;											/**< objects allocated and not freed */
+}pool_t;
+
+// ------------------------------------------------------------ Functions ----------------------------------------------------------
+
+/**
+ * @brief creates a new pool of objects of 'objectSize' bytes, 'POOL_SLAB_OBJECTS' per slab. No memory is reserved until the first allocation
+*/
+pool_t *pool_new(size_t objectSize);
+
+/**
+ * @brief creates a new pool
+ * @param objectSize: size of the objects, rounded up to keep them aligned
+ * @param slabObjects: objects per slab
+*/
+pool_t *pool_new_custom(size_t objectSize, size_t slabObjects);
+
+/**
+ * @brief frees the pool and every object allocated from it
+*/
+void pool_destroy(pool_t *p);
+
+/**
+ * @brief allocate an object. Memory is not initialized
+ * @attention O(1)
+*/
+void *pool_alloc(pool_t *p);
+
+/**
+ * @brief allocate a zeroed object
+ * @attention O(1)
+*/
+void *pool_calloc(pool_t *p);
+
+/**
+ * @brief give an object back to the pool it was allocated from
+ * @attention O(1)
+*/
+void pool_free(pool_t *p, void *ptr);
+
+/**
+ * @brief objects allocated and not freed
+*/
+size_t pool_live(const pool_t *p);
+
+#endif
@@ -0,0 +1,934 @@
+#include "regex_dfa.h"
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "data.h"
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+typedef struct{
+	uint64_t bits[4];
+}byteset_t;
+
+typedef enum{
+	node_set,
+	node_cat,
+	node_alt,
+	node_group,
+	node_repeat,
+}node_type_t;
+
+typedef struct{
+	node_type_t type;
+	int set;
+	int group;
+	int min;
+	int max;												// -1 for unbounded
+	int left;
+	int right;
+}regex_node_t;
+
+typedef enum{
+	inst_set,
+	inst_split,
+	inst_jmp,
+	inst_save,
+	inst_match,
+}inst_op_t;
+
+typedef struct{
+	inst_op_t op;
+	int x;
+	int y;
+}inst_t;
+
+typedef struct{
+	int *insts;												// sorted set and match instructions of the NFA
+	size_t size;
+	bool accept;
+	int *next;												// next state by byte class, -1 if not computed yet
+}dfa_state_t;
+
+typedef struct{
+	dfa_state_t *states;
+	size_t size;
+	size_t allocated;
+	hashtable_t *index;										// instruction set -> state + 1
+	int start;
+	bool unanchored;
+}dfa_t;
+
+struct regex_dfa_t{
+	inst_t *prog;
+	size_t progSize;
+	byteset_t *sets;
+	size_t setsSize;
+	uint8_t classes[256];									// byte -> byte class, bytes in the same class are never told apart by the pattern
+	uint8_t classRep[256];									// byte class -> a byte of the class
+	size_t classesSize;
+	byteset_t first;										// bytes that can start a match
+	int firstByte;											// the only byte that can start a match, -1 if more than one
+	bool nullable;
+	size_t groups;
+	dfa_t anchored;
+	dfa_t unanchored;
+	pthread_mutex_t lock;
+
+	// scratch space
+	int *stack;
+	unsigned int *marks;
+	unsigned int mark;
+	int *seeds;
+	regoff_t *threadCaps[2];
+	int *threadPcs[2];
+};
+
+typedef struct{
+	const char *p;
+	regex_node_t *nodes;
+	size_t nodesSize;
+	size_t nodesAllocated;
+	byteset_t *sets;
+	size_t setsSize;
+	size_t setsAllocated;
+	int groups;
+	bool error;
+}parser_t;
+
+// ------------------------------------------------------------ Byte sets ----------------------------------------------------------
+
+static inline void byteset_add(byteset_t *s, uint8_t c){
+	s->bits[c >> 6] |= 1ULL << (c & 63);
+}
+
+static inline bool byteset_has(const byteset_t *s, uint8_t c){
+	return (s->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+static void byteset_add_range(byteset_t *s, uint8_t from, uint8_t to){
+	for(int c = from; c <= to; c++)
+		byteset_add(s, c);
+}
+
+static void byteset_add_ctype(byteset_t *s, int (*is)(int)){
+	for(int c = 0; c < 256; c++)
+		if(is(c)) byteset_add(s, c);
+}
+
+// every negated set is compiled with REG_NEWLINE, so '\n' is never part of it
+static void byteset_negate(byteset_t *s){
+	for(int i = 0; i < 4; i++)
+		s->bits[i] = ~s->bits[i];
+	s->bits['\n' >> 6] &= ~(1ULL << ('\n' & 63));
+}
+
+static int isword(int c){
+	return isalnum(c) || c == '_';
+}
+
+// ------------------------------------------------------------ Parser -------------------------------------------------------------
+
+static int parser_node(parser_t *p, node_type_t type){
+	if(p->nodesSize == p->nodesAllocated){
+		p->nodesAllocated = p->nodesAllocated ? p->nodesAllocated * 2 : 64;
+		p->nodes = realloc(p->nodes, p->nodesAllocated * sizeof(regex_node_t));
+	}
+
+	p->nodes[p->nodesSize] = (regex_node_t){.type = type, .left = -1, .right = -1, .set = -1, .group = -1};
+	return p->nodesSize++;
+}
+
+static int parser_set(parser_t *p, byteset_t set){
+	if(p->setsSize == p->setsAllocated){
+		p->setsAllocated = p->setsAllocated ? p->setsAllocated * 2 : 16;
+		p->sets = realloc(p->sets, p->setsAllocated * sizeof(byteset_t));
+	}
+
+	p->sets[p->setsSize] = set;
+	int n = parser_node(p, node_set);
+	p->nodes[n].set = p->setsSize++;
+	return n;
+}
+
+static int parser_binary(parser_t *p, node_type_t type, int left, int right){
+	if(left < 0) return right;
+	if(right < 0) return left;
+	int n = parser_node(p, type);
+	p->nodes[n].left = left;
+	p->nodes[n].right = right;
+	return n;
+}
+
+// !trivial
+static bool parser_named_class(parser_t *p, byteset_t *set){
+	static const struct{ const char *name; int (*is)(int); }named[] = {
+		{"digit", isdigit}, {"alpha", isalpha}, {"alnum", isalnum}, {"space", isspace},
+		{"upper", isupper}, {"lower", islower}, {"xdigit", isxdigit}, {"punct", ispunct},
+	};
+
+	const char *end = strstr(p->p, ":]");
+	if(end == NULL) return false;
+
+	size_t len = end - p->p;
+	for(size_t i = 0; i < sizeof(named) / sizeof(named[0]); i++){
+		if(strlen(named[i].name) == len && !strncmp(named[i].name, p->p, len)){
+			byteset_add_ctype(set, named[i].is);
+			p->p = end + 2;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// !trivial
+// bracket expression, backslashes are literal inside of it like in POSIX
+static int parser_bracket(parser_t *p){
+	byteset_t set = {0};
+	bool negate = false;
+
+	if(*p->p == '^'){
+		negate = true;
+		p->p++;
+	}
+
+	bool first = true;
+	while(*p->p != '\0' && (first || *p->p != ']')){
+		first = false;
+
+		if(p->p[0] == '[' && p->p[1] == ':'){
+			p->p += 2;
+			if(!parser_named_class(p, &set)) break;
+			continue;
+		}
+
+		// collating elements and equivalence classes
+		if(p->p[0] == '[' && (p->p[1] == '.' || p->p[1] == '='))
+			break;
+
+		uint8_t lo = *p->p++;
+		if(p->p[0] == '-' && p->p[1] != ']' && p->p[1] != '\0'){
+			uint8_t hi = p->p[1];
+			if(hi < lo || hi == '[') break;
+			byteset_add_range(&set, lo, hi);
+			p->p += 2;
+		}
+		else{
+			byteset_add(&set, lo);
+		}
+	}
+
+	if(*p->p != ']'){
+		p->error = true;
+		return -1;
+	}
+
+	p->p++;
+
+	if(negate)
+		byteset_negate(&set);
+
+	return parser_set(p, set);
+}
+
+// !trivial
+static int parser_escape(parser_t *p){
+	byteset_t set = {0};
+	char c = *p->p++;
+
+	switch(c){
+		case 'd': byteset_add_range(&set, '0', '9'); break;
+		case 'D': byteset_add_range(&set, '0', '9'); byteset_negate(&set); break;
+		case 'w': byteset_add_ctype(&set, isword); break;
+		case 'W': byteset_add_ctype(&set, isword); byteset_negate(&set); break;
+		case 's': byteset_add_ctype(&set, isspace); break;
+		case 'S': byteset_add_ctype(&set, isspace); byteset_negate(&set); break;
+
+		default:
+			// back references, word boundaries and other letter escapes are unsupported
+			if(c == '\0' || isalnum((unsigned char)c)){
+				p->error = true;
+				return -1;
+			}
+
+			byteset_add(&set, c);
+			break;
+	}
+
+	return parser_set(p, set);
+}
+
+static int parser_alt(parser_t *p);
+
+// !trivial
+static int parser_atom(parser_t *p){
+	char c = *p->p;
+
+	switch(c){
+		case '(':{
+			p->p++;
+			// empty groups and perl extensions
+			if(*p->p == ')' || *p->p == '?'){
+				p->error = true;
+				return -1;
+			}
+
+			int group = ++p->groups;
+			int child = parser_alt(p);
+			if(p->error || *p->p != ')'){
+				p->error = true;
+				return -1;
+			}
+
+			p->p++;
+			int n = parser_node(p, node_group);
+			p->nodes[n].group = group;
+			p->nodes[n].left = child;
+			return n;
+		}
+
+		case '[':
+			p->p++;
+			return parser_bracket(p);
+
+		case '\\':
+			p->p++;
+			return parser_escape(p);
+
+		case '.':{
+			p->p++;
+			byteset_t set = {0};
+			byteset_negate(&set);
+			return parser_set(p, set);
+		}
+
+		// anchors, and repetitions without anything to repeat
+		case '^':
+		case '$':
+		case '*':
+		case '+':
+		case '?':
+		case '{':
+			p->error = true;
+			return -1;
+
+		default:{
+			p->p++;
+			byteset_t set = {0};
+			byteset_add(&set, c);
+			return parser_set(p, set);
+		}
+	}
+}
+
+// !trivial
+static bool parser_interval(parser_t *p, int *min, int *max){
+	char *end;
+	if(!isdigit((unsigned char)*p->p)) return false;
+	*min = strtol(p->p, &end, 10);
+	p->p = end;
+
+	if(*p->p == '}'){
+		*max = *min;
+	}
+	else if(*p->p == ','){
+		p->p++;
+		if(*p->p == '}'){
+			*max = -1;
+		}
+		else{
+			if(!isdigit((unsigned char)*p->p)) return false;
+			*max = strtol(p->p, &end, 10);
+			p->p = end;
+			if(*max < *min) return false;
+		}
+	}
+
+	if(*p->p != '}' || *min > 255 || *max > 255) return false;
+	p->p++;
+	return true;
+}
+
+// !trivial
+static int parser_repeat(parser_t *p){
+	int atom = parser_atom(p);
+	if(p->error) return -1;
+
+	int min, max;
+	switch(*p->p){
+		case '*': min = 0; max = -1; break;
+		case '+': min = 1; max = -1; break;
+		case '?': min = 0; max = 1;  break;
+		case '{':
+			p->p++;
+			if(!parser_interval(p, &min, &max)){
+				p->error = true;
+				return -1;
+			}
+			p->p--;
+			break;
+		default:
+			return atom;
+	}
+
+	p->p++;
+
+	// stacked repetitions
+	if(*p->p == '*' || *p->p == '+' || *p->p == '?' || *p->p == '{'){
+		p->error = true;
+		return -1;
+	}
+
+	int n = parser_node(p, node_repeat);
+	p->nodes[n].left = atom;
+	p->nodes[n].min = min;
+	p->nodes[n].max = max;
+	return n;
+}
+
+static int parser_cat(parser_t *p){
+	int cat = -1;
+	while(*p->p != '\0' && *p->p != '|' && *p->p != ')' && !p->error)
+		cat = parser_binary(p, node_cat, cat, parser_repeat(p));
+
+	// empty alternatives
+	if(cat < 0) p->error = true;
+	return cat;
+}
+
+static int parser_alt(parser_t *p){
+	int alt = parser_cat(p);
+	while(*p->p == '|' && !p->error){
+		p->p++;
+		alt = parser_binary(p, node_alt, alt, parser_cat(p));
+	}
+
+	return alt;
+}
+
+// ------------------------------------------------------------ Compiler -----------------------------------------------------------
+
+static int prog_emit(regex_dfa_t *re, inst_op_t op, int x, int y){
+	if(re->progSize >= REGEX_DFA_MAX_PROGRAM) return -1;
+	re->prog[re->progSize] = (inst_t){.op = op, .x = x, .y = y};
+	return re->progSize++;
+}
+
+// !trivial
+// thompson construction, split instructions try 'x' before 'y'
+static bool prog_compile(regex_dfa_t *re, const parser_t *p, int n){
+	const regex_node_t *node = &p->nodes[n];
+
+	switch(node->type){
+		case node_set:
+			return prog_emit(re, inst_set, node->set, 0) >= 0;
+
+		case node_cat:
+			return prog_compile(re, p, node->left) && prog_compile(re, p, node->right);
+
+		case node_alt:{
+			int split = prog_emit(re, inst_split, 0, 0);
+			if(split < 0) return false;
+			re->prog[split].x = re->progSize;
+			if(!prog_compile(re, p, node->left)) return false;
+			int jmp = prog_emit(re, inst_jmp, 0, 0);
+			if(jmp < 0) return false;
+			re->prog[split].y = re->progSize;
+			if(!prog_compile(re, p, node->right)) return false;
+			re->prog[jmp].x = re->progSize;
+			return true;
+		}
+
+		case node_group:
+			return
+				prog_emit(re, inst_save, node->group * 2, 0) >= 0 &&
+				prog_compile(re, p, node->left) &&
+				prog_emit(re, inst_save, node->group * 2 + 1, 0) >= 0;
+
+		case node_repeat:{
+			for(int i = 0; i < node->min; i++)
+				if(!prog_compile(re, p, node->left)) return false;
+
+			if(node->max < 0){
+				int split = prog_emit(re, inst_split, 0, 0);
+				if(split < 0) return false;
+				re->prog[split].x = re->progSize;
+				if(!prog_compile(re, p, node->left)) return false;
+				if(prog_emit(re, inst_jmp, split, 0) < 0) return false;
+				re->prog[split].y = re->progSize;
+				return true;
+			}
+
+			// optional copies all skip to the end
+			int optional = node->max - node->min;
+			int splits[256];
+			for(int i = 0; i < optional; i++){
+				splits[i] = prog_emit(re, inst_split, 0, 0);
+				if(splits[i] < 0) return false;
+				re->prog[splits[i]].x = re->progSize;
+				if(!prog_compile(re, p, node->left)) return false;
+			}
+
+			for(int i = 0; i < optional; i++)
+				re->prog[splits[i]].y = re->progSize;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// !trivial
+// group bytes that no set tells apart, so DFA transitions are stored per class instead of per byte
+static void prog_classes(regex_dfa_t *re){
+	memset(re->classes, 0, sizeof(re->classes));
+	re->classesSize = 1;
+
+	uint8_t refined[256];
+	for(size_t s = 0; s < re->setsSize; s++){
+		int map[512];
+		memset(map, -1, sizeof(map));
+		size_t size = 0;
+
+		for(int c = 0; c < 256; c++){
+			int key = re->classes[c] * 2 + byteset_has(&re->sets[s], c);
+			if(map[key] < 0) map[key] = size++;
+			refined[c] = map[key];
+		}
+
+		memcpy(re->classes, refined, sizeof(refined));
+		re->classesSize = size;
+	}
+
+	for(int c = 255; c >= 0; c--)
+		re->classRep[re->classes[c]] = c;
+}
+
+// ------------------------------------------------------------ DFA ----------------------------------------------------------------
+
+// new generation for the visited marks of the instructions
+static void regex_dfa_next_mark(regex_dfa_t *re){
+	if(++re->mark == 0){
+		memset(re->marks, 0, re->progSize * sizeof(unsigned int));
+		re->mark = 1;
+	}
+}
+
+// !trivial
+// epsilon closure of the seeds, only set and match instructions are kept, sorted
+static size_t dfa_closure(regex_dfa_t *re, const int *seeds, size_t seedsSize, int *out){
+	regex_dfa_next_mark(re);
+	size_t size = 0;
+	size_t top = 0;
+
+	for(size_t i = seedsSize; i > 0; i--)
+		re->stack[top++] = seeds[i - 1];
+
+	while(top > 0){
+		int pc = re->stack[--top];
+		if(re->marks[pc] == re->mark) continue;
+		re->marks[pc] = re->mark;
+
+		const inst_t *inst = &re->prog[pc];
+		switch(inst->op){
+			case inst_set:
+			case inst_match:
+				out[size++] = pc;
+				break;
+			case inst_jmp:
+				re->stack[top++] = inst->x;
+				break;
+			case inst_split:
+				re->stack[top++] = inst->y;
+				re->stack[top++] = inst->x;
+				break;
+			case inst_save:
+				re->stack[top++] = pc + 1;
+				break;
+		}
+	}
+
+	// insertion sort, sets are small
+	for(size_t i = 1; i < size; i++){
+		int v = out[i];
+		size_t j = i;
+		for(; j > 0 && out[j - 1] > v; j--)
+			out[j] = out[j - 1];
+		out[j] = v;
+	}
+
+	return size;
+}
+
+// !trivial
+static int dfa_state(regex_dfa_t *re, dfa_t *dfa, const int *insts, size_t size){
+	size_t keySize = size * sizeof(int);
+	// the empty set still needs a key
+	int dead = -1;
+	const void *key = size > 0 ? (const void*)insts : (const void*)&dead;
+	if(size == 0) keySize = sizeof(int);
+
+	size_t found = (size_t)hashtable_get_bin(dfa->index, (void*)key, keySize);
+	if(found > 0) return found - 1;
+
+	if(dfa->size == dfa->allocated){
+		dfa->allocated = dfa->allocated ? dfa->allocated * 2 : 16;
+		dfa->states = realloc(dfa->states, dfa->allocated * sizeof(dfa_state_t));
+	}
+
+	dfa_state_t *state = &dfa->states[dfa->size];
+	state->size = size;
+	state->insts = malloc(keySize);
+	memcpy(state->insts, key, keySize);
+	state->accept = false;
+	for(size_t i = 0; i < size; i++)
+		if(re->prog[insts[i]].op == inst_match)
+			state->accept = true;
+
+	state->next = malloc(re->classesSize * sizeof(int));
+	memset(state->next, -1, re->classesSize * sizeof(int));
+
+	hashtable_set_bin(dfa->index, state->insts, keySize, (void*)(dfa->size + 1));
+	return dfa->size++;
+}
+
+static void dfa_free(dfa_t *dfa){
+	for(size_t i = 0; i < dfa->size; i++){
+		free(dfa->states[i].insts);
+		free(dfa->states[i].next);
+	}
+
+	if(dfa->index != NULL)
+		hashtable_destroy(dfa->index);
+
+	free(dfa->states);
+	*dfa = (dfa_t){.unanchored = dfa->unanchored};
+}
+
+static void dfa_init(regex_dfa_t *re, dfa_t *dfa){
+	dfa->index = hashtable_new(REGEX_DFA_MAX_STATES * 2);
+	int seed = 0;
+	size_t size = dfa_closure(re, &seed, 1, re->seeds);
+	dfa->start = dfa_state(re, dfa, re->seeds, size);
+}
+
+// !trivial
+static int dfa_step(regex_dfa_t *re, dfa_t *dfa, int from, uint8_t byteClass){
+	int to = dfa->states[from].next[byteClass];
+	if(to >= 0) return to;
+
+	// compute transition
+	uint8_t c = re->classRep[byteClass];
+	const dfa_state_t *state = &dfa->states[from];
+	size_t seedsSize = 0;
+	for(size_t i = 0; i < state->size; i++){
+		const inst_t *inst = &re->prog[state->insts[i]];
+		if(inst->op == inst_set && byteset_has(&re->sets[inst->x], c))
+			re->seeds[seedsSize++] = state->insts[i] + 1;
+	}
+
+	// a new match can start anywhere
+	if(dfa->unanchored)
+		re->seeds[seedsSize++] = 0;
+
+	int *insts = re->seeds + seedsSize;
+	size_t size = dfa_closure(re, re->seeds, seedsSize, insts);
+
+	// cache full, start over keeping only the states in use
+	if(dfa->size >= REGEX_DFA_MAX_STATES){
+		int *keep = malloc(size * sizeof(int) + 1);
+		memcpy(keep, insts, size * sizeof(int));
+		dfa_free(dfa);
+		dfa_init(re, dfa);
+		to = dfa_state(re, dfa, keep, size);
+		free(keep);
+		return to;
+	}
+
+	to = dfa_state(re, dfa, insts, size);
+	dfa->states[from].next[byteClass] = to;
+	return to;
+}
+
+// ------------------------------------------------------------ Captures -----------------------------------------------------------
+
+// !trivial
+static void pike_add(regex_dfa_t *re, int *pcs, regoff_t *caps, size_t *size, int pc, regoff_t *threadCaps, regoff_t pos){
+	if(re->marks[pc] == re->mark) return;
+	re->marks[pc] = re->mark;
+
+	const inst_t *inst = &re->prog[pc];
+	switch(inst->op){
+		case inst_jmp:
+			pike_add(re, pcs, caps, size, inst->x, threadCaps, pos);
+			break;
+		case inst_split:
+			pike_add(re, pcs, caps, size, inst->x, threadCaps, pos);
+			pike_add(re, pcs, caps, size, inst->y, threadCaps, pos);
+			break;
+		case inst_save:{
+			regoff_t old = threadCaps[inst->x];
+			threadCaps[inst->x] = pos;
+			pike_add(re, pcs, caps, size, pc + 1, threadCaps, pos);
+			threadCaps[inst->x] = old;
+			break;
+		}
+		default:
+			pcs[*size] = pc;
+			memcpy(caps + *size * re->groups * 2, threadCaps, re->groups * 2 * sizeof(regoff_t));
+			(*size)++;
+			break;
+	}
+}
+
+// !trivial
+// one pass over a known match span, running all NFA threads in priority order to find where each group landed
+static void pike_captures(regex_dfa_t *re, const char *text, regoff_t start, regoff_t end, regoff_t *result){
+	size_t ncaps = re->groups * 2;
+	regoff_t threadCaps[ncaps];
+	for(size_t i = 0; i < ncaps; i++)
+		threadCaps[i] = -1;
+
+	size_t size[2] = {0, 0};
+	int cur = 0;
+
+	regex_dfa_next_mark(re);
+	pike_add(re, re->threadPcs[cur], re->threadCaps[cur], &size[cur], 0, threadCaps, start);
+
+	for(regoff_t pos = start; ; pos++){
+		int nxt = 1 - cur;
+		size[nxt] = 0;
+		regex_dfa_next_mark(re);
+
+		for(size_t t = 0; t < size[cur]; t++){
+			int pc = re->threadPcs[cur][t];
+			regoff_t *caps = re->threadCaps[cur] + t * ncaps;
+			const inst_t *inst = &re->prog[pc];
+
+			if(inst->op == inst_match){
+				// highest priority thread ending where the match ends, lower ones are cut
+				if(pos == end){
+					memcpy(result, caps, ncaps * sizeof(regoff_t));
+					return;
+				}
+				continue;
+			}
+
+			if(pos < end && byteset_has(&re->sets[inst->x], (uint8_t)text[pos]))
+				pike_add(re, re->threadPcs[nxt], re->threadCaps[nxt], &size[nxt], pc + 1, caps, pos + 1);
+		}
+
+		if(pos >= end || size[nxt] == 0) break;
+		cur = nxt;
+	}
+
+	result[0] = start;
+	result[1] = end;
+}
+
+// ------------------------------------------------------------ Regex --------------------------------------------------------------
+
+// !trivial
+regex_dfa_t *regex_dfa_compile(const char *pattern){
+	if(pattern == NULL || *pattern == '\0') return NULL;
+
+	parser_t p = {.p = pattern};
+	int root = parser_alt(&p);
+	if(p.error || *p.p != '\0' || root < 0){
+		free(p.nodes);
+		free(p.sets);
+		return NULL;
+	}
+
+	regex_dfa_t *re = calloc(1, sizeof(regex_dfa_t));
+	re->prog = malloc(REGEX_DFA_MAX_PROGRAM * sizeof(inst_t));
+	re->sets = p.sets;
+	re->setsSize = p.setsSize;
+	re->groups = p.groups + 1;
+
+	// whole match is group 0
+	bool compiled =
+		prog_emit(re, inst_save, 0, 0) >= 0 &&
+		prog_compile(re, &p, root) &&
+		prog_emit(re, inst_save, 1, 0) >= 0 &&
+		prog_emit(re, inst_match, 0, 0) >= 0;
+
+	free(p.nodes);
+
+	if(!compiled){
+		free(re->prog);
+		free(re->sets);
+		free(re);
+		return NULL;
+	}
+
+	prog_classes(re);
+
+	re->stack = malloc((re->progSize * 3 + 2) * sizeof(int));
+	re->marks = calloc(re->progSize, sizeof(unsigned int));
+	re->seeds = malloc(re->progSize * 3 * sizeof(int));
+	for(int i = 0; i < 2; i++){
+		re->threadPcs[i] = malloc(re->progSize * sizeof(int));
+		re->threadCaps[i] = malloc(re->progSize * re->groups * 2 * sizeof(regoff_t));
+	}
+
+	// what can start a match
+	int seed = 0;
+	size_t size = dfa_closure(re, &seed, 1, re->seeds);
+	re->firstByte = -1;
+	size_t firstCount = 0;
+	for(size_t i = 0; i < size; i++){
+		const inst_t *inst = &re->prog[re->seeds[i]];
+		if(inst->op == inst_match){
+			re->nullable = true;
+			continue;
+		}
+
+		for(int w = 0; w < 4; w++)
+			re->first.bits[w] |= re->sets[inst->x].bits[w];
+	}
+
+	for(int c = 0; c < 256; c++){
+		if(byteset_has(&re->first, c)){
+			re->firstByte = c;
+			firstCount++;
+		}
+	}
+
+	if(firstCount != 1)
+		re->firstByte = -1;
+
+	re->unanchored.unanchored = true;
+	dfa_init(re, &re->anchored);
+	dfa_init(re, &re->unanchored);
+	pthread_mutex_init(&re->lock, NULL);
+	return re;
+}
+
+void regex_dfa_destroy(regex_dfa_t *re){
+	if(re == NULL) return;
+
+	dfa_free(&re->anchored);
+	dfa_free(&re->unanchored);
+	pthread_mutex_destroy(&re->lock);
+
+	for(int i = 0; i < 2; i++){
+		free(re->threadPcs[i]);
+		free(re->threadCaps[i]);
+	}
+
+	free(re->stack);
+	free(re->marks);
+	free(re->seeds);
+	free(re->prog);
+	free(re->sets);
+	free(re);
+}
+
+size_t regex_dfa_groups(const regex_dfa_t *re){
+	return re->groups;
+}
+
+// !trivial
+// next position that can start a match, 'len' if none
+static size_t regex_dfa_skip(const regex_dfa_t *re, const char *text, size_t from, size_t len){
+	if(re->nullable) return from;
+
+	if(re->firstByte >= 0){
+		const char *found = memchr(text + from, re->firstByte, len - from);
+		return found != NULL ? (size_t)(found - text) : len;
+	}
+
+	while(from < len && !byteset_has(&re->first, (uint8_t)text[from]))
+		from++;
+
+	return from;
+}
+
+// !trivial
+// end of the earliest ending match at or after 'from', -1 if none
+static regoff_t regex_dfa_earliest_end(regex_dfa_t *re, const char *text, size_t from, size_t len){
+	dfa_t *dfa = &re->unanchored;
+	int state = dfa->start;
+	if(dfa->states[state].accept) return from;
+
+	for(size_t i = from; i < len; i++){
+		// nothing going on, jump to the next possible start
+		if(state == dfa->start){
+			i = regex_dfa_skip(re, text, i, len);
+			if(i >= len) break;
+		}
+
+		state = dfa_step(re, dfa, state, re->classes[(uint8_t)text[i]]);
+		if(dfa->states[state].accept)
+			return i + 1;
+	}
+
+	return -1;
+}
+
+// !trivial
+// end of the longest match starting exactly at 'from', -1 if none
+static regoff_t regex_dfa_longest_at(regex_dfa_t *re, const char *text, size_t from, size_t len){
+	dfa_t *dfa = &re->anchored;
+	int state = dfa->start;
+	regoff_t last = dfa->states[state].accept ? (regoff_t)from : -1;
+
+	for(size_t i = from; i < len; i++){
+		state = dfa_step(re, dfa, state, re->classes[(uint8_t)text[i]]);
+		if(dfa->states[state].size == 0) break;
+		if(dfa->states[state].accept) last = i + 1;
+	}
+
+	return last;
+}
+
+// !trivial
+int regex_dfa_exec(regex_dfa_t *re, const char *text, size_t len, size_t nmatch, regmatch_t *pmatch){
+	pthread_mutex_lock(&re->lock);
+
+	size_t from = regex_dfa_skip(re, text, 0, len);
+	regoff_t earliest = from < len || re->nullable ? regex_dfa_earliest_end(re, text, from, len) : -1;
+	if(earliest < 0){
+		pthread_mutex_unlock(&re->lock);
+		return REG_NOMATCH;
+	}
+
+	// the match ending first starts at or before its end, so the leftmost match starts there too
+	regoff_t start = -1;
+	regoff_t end = -1;
+	for(size_t i = from; i <= (size_t)earliest; i = regex_dfa_skip(re, text, i + 1, len)){
+		end = regex_dfa_longest_at(re, text, i, len);
+		if(end >= 0){
+			start = i;
+			break;
+		}
+
+		if(i >= len) break;
+	}
+
+	if(start < 0){
+		pthread_mutex_unlock(&re->lock);
+		return REG_NOMATCH;
+	}
+
+	if(nmatch > 1 && re->groups > 1){
+		regoff_t caps[re->groups * 2];
+		pike_captures(re, text, start, end, caps);
+
+		for(size_t i = 0; i < nmatch; i++){
+			pmatch[i].rm_so = i < re->groups ? caps[i * 2] : -1;
+			pmatch[i].rm_eo = i < re->groups ? caps[i * 2 + 1] : -1;
+		}
+	}
+	else if(nmatch > 0){
+		pmatch[0].rm_so = start;
+		pmatch[0].rm_eo = end;
+		for(size_t i = 1; i < nmatch; i++)
+			pmatch[i].rm_so = pmatch[i].rm_eo = -1;
+	}
+
+	pthread_mutex_unlock(&re->lock);
+	return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef _REGEX_DFA_HEADER_
+#define _REGEX_DFA_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <regex.h>
+
+/**
+ * @file Built in regex engine for the subset of POSIX extended regex the solutions use:
+ * literals, '.', bracket classes like '[a-z]', '[^,]' and '[[:digit:]]', the shorthands '\d', '\w', '\s' and their negations,
+ * groups, alternation and the repetitions '*', '+', '?', '{n}', '{n,}' and '{n,m}'.
+ * Patterns are compiled to an NFA that is turned into a DFA lazily, one state at a time while matching.
+ * Matches are leftmost longest like POSIX, capture groups are then extracted in a single pass over the matched text,
+ * preferring the leftmost alternatives when a group could match in more than one way.
+ * Matching follows 'REG_NEWLINE', so '.' and negated classes don't match '\n'.
+ * Anything else, like anchors or back references, makes 'regex_dfa_compile' fail so the caller can fallback to 'regcomp'
+*/
+
+// maximum number of NFA instructions, bigger patterns fail to compile
+#define REGEX_DFA_MAX_PROGRAM 4096
+
+// maximum number of DFA states kept in the cache, the cache is flushed and built again when full
+#define REGEX_DFA_MAX_STATES 2048
+
+typedef struct regex_dfa_t regex_dfa_t;
+
+/**
+ * @brief compile a pattern
+ * @return the compiled pattern or NULL if it uses syntax outside of the supported subset or is invalid
+*/
+regex_dfa_t *regex_dfa_compile(const char *pattern);
+
+/**
+ * @brief free a compiled pattern
+*/
+void regex_dfa_destroy(regex_dfa_t *re);
+
+/**
+ * @brief number of capture slots of the pattern: the whole match plus one for each group
+*/
+size_t regex_dfa_groups(const regex_dfa_t *re);
+
+/**
+ * @brief search 'text' for the leftmost longest match, like 'regexec' with 'REG_STARTEND'. Thread safe
+ * @param re: compiled pattern
+ * @param text: text to search, doesn't need to be null terminated
+ * @param len: length of 'text'
+ * @param nmatch: size of 'pmatch'
+ * @param pmatch: receives the match and groups offsets, relative to 'text'. Groups that didn't participate are set to -1
+ * @return 0 on match, 'REG_NOMATCH' otherwise
+*/
+int regex_dfa_exec(regex_dfa_t *re, const char *text, size_t len, size_t nmatch, regmatch_t *pmatch);
+
+#endif
@@ -0,0 +1,306 @@
+#include "sort.h"
+#include "worker.h"
+#include <unistd.h>
+
+// ------------------------------------------------------------ Radix sort ---------------------------------------------------------
+
+#define sort_less_scalar(a, b) ((a) < (b))
+SORT_DEFINE(sort_small_u32, uint32_t, sort_less_scalar)
+SORT_DEFINE(sort_small_u64, uint64_t, sort_less_scalar)
+
+// !trivial
+// LSD radix sort on 'bytes' bytes of 'T' keys xored with 'flip', all the histograms are counted in one pass
+#define SORT_RADIX_DEFINE(name, T, bytes)																		\
+static void name(T *data, size_t size, T flip){																	\
+	T *tmp = malloc(size * sizeof(T));																			\
+	size_t (*counts)[256] = calloc(bytes, sizeof(*counts));														\
+	for(size_t i = 0; i < size; i++){																			\
+		T v = data[i] ^ flip;																					\
+		for(size_t b = 0; b < bytes; b++)																		\
+			counts[b][(v >> (b * 8)) & 0xFF]++;																	\
+	}																											\
+																												\
+	T *src = data;																								\
+	T *dest = tmp;																								\
+	for(size_t b = 0; b < bytes; b++){																			\
+		/* all the keys share this byte, the pass wouldn't move anything */										\
+		if(counts[b][((src[0] ^ flip) >> (b * 8)) & 0xFF] == size) continue;									\
+																												\
+		size_t pos = 0;																							\
+		for(size_t d = 0; d < 256; d++){																		\
+			size_t c = counts[b][d];																			\
+			counts[b][d] = pos;																					\
+			pos += c;																							\
+		}																										\
+		for(size_t i = 0; i < size; i++)																		\
+			dest[counts[b][((src[i] ^ flip) >> (b * 8)) & 0xFF]++] = src[i];									\
+																												\
+		T *t = src;																								\
+		src = dest;																								\
+		dest = t;																								\
+	}																											\
+																												\
+	if(src != data)																								\
+		memcpy(data, src, size * sizeof(T));																	\
+	free(counts);																								\
+	free(tmp);																									\
+}
+
+SORT_RADIX_DEFINE(sort_radix_u32_raw, uint32_t, 4)
+SORT_RADIX_DEFINE(sort_radix_u64_raw, uint64_t, 8)
+
+#undef SORT_RADIX_DEFINE
+
+void sort_radix_u32(uint32_t *data, size_t size){
+	if(size <= SORT_SMALL)
+		sort_small_u32(data, size);
+	else
+		sort_radix_u32_raw(data, size, 0);
+}
+
+void sort_radix_u64(uint64_t *data, size_t size){
+	if(size <= SORT_SMALL)
+		sort_small_u64(data, size);
+	else
+		sort_radix_u64_raw(data, size, 0);
+}
+
+// !trivial
+// flipping the sign bit orders two's complement values as unsigned ones
+void sort_radix_i64(int64_t *data, size_t size){
+	uint64_t sign = (uint64_t)1 << 63;
+	if(size <= SORT_SMALL){
+		for(size_t i = 0; i < size; i++)
+			data[i] ^= sign;
+		sort_small_u64((uint64_t*)data, size);
+		for(size_t i = 0; i < size; i++)
+			data[i] ^= sign;
+	}
+	else
+		sort_radix_u64_raw((uint64_t*)data, size, sign);
+}
+
+typedef struct{
+	uint64_t key;
+	size_t index;
+}sort_key_t;
+
+// !trivial
+void sort_radix_by_key(void *data, size_t size, size_t elementSize, sortKeyFunc key){
+	if(size < 2) return;
+
+	sort_key_t *keys = malloc(size * sizeof(sort_key_t));
+	sort_key_t *tmp = malloc(size * sizeof(sort_key_t));
+	size_t counts[8][256] = {0};
+	for(size_t i = 0; i < size; i++){
+		keys[i].key = key((uint8_t*)data + i * elementSize);
+		keys[i].index = i;
+		for(size_t b = 0; b < 8; b++)
+			counts[b][(keys[i].key >> (b * 8)) & 0xFF]++;
+	}
+
+	sort_key_t *src = keys;
+	sort_key_t *dest = tmp;
+	for(size_t b = 0; b < 8; b++){
+		if(counts[b][(src[0].key >> (b * 8)) & 0xFF] == size) continue;
+
+		size_t pos = 0;
+		for(size_t d = 0; d < 256; d++){
+			size_t c = counts[b][d];
+			counts[b][d] = pos;
+			pos += c;
+		}
+		for(size_t i = 0; i < size; i++)
+			dest[counts[b][(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+
+		sort_key_t *t = src;
+		src = dest;
+		dest = t;
+	}
+
+	// gather the elements in order, then copy them back
+	uint8_t *sorted = malloc(size * elementSize);
+	for(size_t i = 0; i < size; i++)
+		memcpy(sorted + i * elementSize, (uint8_t*)data + src[i].index * elementSize, elementSize);
+	memcpy(data, sorted, size * elementSize);
+
+	free(sorted);
+	free(keys);
+	free(tmp);
+}
+
+// ------------------------------------------------------------ Merge sort ---------------------------------------------------------
+
+typedef struct{
+	void **src;
+	void **dest;
+	size_t begin;
+	size_t middle;
+	size_t end;
+	orderFunc order;
+}sort_task_t;
+
+// !trivial
+// stable insertion sort of [begin, end)
+static void sort_insertion(void **values, size_t begin, size_t end, orderFunc order){
+	for(size_t i = begin + 1; i < end; i++){
+		void *value = values[i];
+		size_t j = i;
+		for(; j > begin && order(values[j - 1], value) > 0; j--)
+			values[j] = values[j - 1];
+		values[j] = value;
+	}
+}
+
+// !trivial
+// merge the sorted runs [begin, middle) and [middle, end) of 'src' into 'dest', ties taken from the left run
+static void sort_merge(void **src, void **dest, size_t begin, size_t middle, size_t end, orderFunc order){
+	size_t i = begin;
+	size_t j = middle;
+	size_t k = begin;
+
+	// already in order, common on partially sorted input
+	if(i < middle && j < end && order(src[middle - 1], src[middle]) <= 0){
+		if(src != dest)
+			memcpy(dest + begin, src + begin, (end - begin) * sizeof(void*));
+		return;
+	}
+
+	while(i < middle && j < end)
+		dest[k++] = order(src[j], src[i]) < 0 ? src[j++] : src[i++];
+	while(i < middle)
+		dest[k++] = src[i++];
+	while(j < end)
+		dest[k++] = src[j++];
+}
+
+// !trivial
+// bottom up merge sort of [begin, end), the result is left in 'values'
+static void sort_merge_range(void **values, void **tmp, size_t begin, size_t end, orderFunc order){
+	for(size_t i = begin; i < end; i += SORT_SMALL)
+		sort_insertion(values, i, i + SORT_SMALL < end ? i + SORT_SMALL : end, order);
+
+	void **src = values;
+	void **dest = tmp;
+	for(size_t width = SORT_SMALL; width < end - begin; width *= 2){
+		for(size_t lo = begin; lo < end; lo += 2 * width){
+			size_t middle = lo + width < end ? lo + width : end;
+			size_t hi = lo + 2 * width < end ? lo + 2 * width : end;
+			sort_merge(src, dest, lo, middle, hi, order);
+		}
+
+		void **t = src;
+		src = dest;
+		dest = t;
+	}
+
+	if(src != values)
+		memcpy(values + begin, src + begin, (end - begin) * sizeof(void*));
+}
+
+static void *sort_range_worker(void *data){
+	sort_task_t *task = data;
+	sort_merge_range(task->src, task->dest, task->begin, task->end, task->order);
+	return NULL;
+}
+
+static void *sort_merge_worker(void *data){
+	sort_task_t *task = data;
+	sort_merge(task->src, task->dest, task->begin, task->middle, task->end, task->order);
+	return NULL;
+}
+
+// !trivial
+// run the tasks, the first one on the calling thread
+static void sort_run(sort_task_t *tasks, size_t count, workerFunction_t f){
+	worker_t **workers = malloc(count * sizeof(worker_t*));
+	for(size_t i = 1; i < count; i++)
+		workers[i] = workerCreate(f, &tasks[i]);
+	f(&tasks[0]);
+	for(size_t i = 1; i < count; i++)
+		workerWait(workers[i]);
+	free(workers);
+}
+
+// !trivial
+void sort_pointers(void **values, size_t size, orderFunc order, size_t threads){
+	if(size < 2) return;
+	if(threads == 0){
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = processors > 0 ? processors : 1;
+	}
+	if(size < SORT_PARALLEL_MIN)
+		threads = 1;
+
+	void **tmp = malloc(size * sizeof(void*));
+	if(threads == 1){
+		sort_merge_range(values, tmp, 0, size, order);
+		free(tmp);
+		return;
+	}
+
+	// each thread sorts a chunk in place
+	sort_task_t *tasks = malloc(threads * sizeof(sort_task_t));
+	size_t chunk = (size + threads - 1) / threads;
+	size_t count = 0;
+	for(size_t begin = 0; begin < size; begin += chunk)
+		tasks[count++] = (sort_task_t){
+			.src = values,
+			.dest = tmp,
+			.begin = begin,
+			.end = begin + chunk < size ? begin + chunk : size,
+			.order = order
+		};
+	sort_run(tasks, count, sort_range_worker);
+
+	// then pairs of chunks are merged in parallel, halving the number of chunks every round
+	void **src = values;
+	void **dest = tmp;
+	for(; chunk < size; chunk *= 2){
+		count = 0;
+		for(size_t begin = 0; begin < size; begin += 2 * chunk)
+			tasks[count++] = (sort_task_t){
+				.src = src,
+				.dest = dest,
+				.begin = begin,
+				.middle = begin + chunk < size ? begin + chunk : size,
+				.end = begin + 2 * chunk < size ? begin + 2 * chunk : size,
+				.order = order
+			};
+		sort_run(tasks, count, sort_merge_worker);
+
+		void **t = src;
+		src = dest;
+		dest = t;
+	}
+
+	if(src != values)
+		memcpy(values, src, size * sizeof(void*));
+	free(tasks);
+	free(tmp);
+}
+
+void sort_array(array_t *a, orderFunc order, size_t threads){
+	sort_pointers(a->raw, a->size, order, threads);
+}
+
+// !trivial
+void sort_list(list_t *l, orderFunc order){
+	if(l->size < 2) return;
+
+	void **values = malloc(l->size * sizeof(void*));
+	size_t i = 0;
+	for(node_t *n = l->first; n != NULL; n = n->next)
+		values[i++] = n->value;
+
+	sort_pointers(values, l->size, order, 1);
+
+	i = 0;
+	for(node_t *n = l->first; n != NULL; n = n->next)
+		n->value = values[i++];
+	free(values);
+
+	// the index maps values to nodes, they moved
+	if(l->index != NULL)
+		list_set_unique(l, l->index->hash, l->index->eq);
+}
@@ -0,0 +1,182 @@
+#ifndef _SORT_HEADER_
+#define _SORT_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data.h"
+
+/**
+ * @file Sorting without 'qsort'. Integer arrays use LSD radix sort, 8 bits per pass, passes where all the elements share
+ * the same byte are skipped. 'SORT_DEFINE' generates a comparison sort with the comparison inlined, for arrays of
+ * any type. Arrays and lists of pointers are sorted by a stable merge sort that can be split across threads.
+ * Don't forget to link against '-lpthread'
+ * @details
+ * #define point_less(a, b) ((a).y < (b).y || ((a).y == (b).y && (a).x < (b).x))
+ * SORT_DEFINE(sort_points, point_t, point_less)
+ *
+ * sort_points(points, size);
+ * sort_radix_u64(values, size);
+ * sort_array(a, order, 0);
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+// below this size the radix and merge sorts use an insertion sort
+#define SORT_SMALL 32
+
+// below this size 'sort_array' and 'sort_pointers' don't start threads
+#define SORT_PARALLEL_MIN 65536
+
+// ------------------------------------------------------------ Types --------------------------------------------------------------
+
+/**
+ * @brief order of two values: negative if 'a' goes before 'b', positive if after, 0 if equal.
+ * Receives the values themselves, not pointers to them like 'qsort'
+*/
+typedef int(*orderFunc)(const void *a, const void *b);
+
+/**
+ * @brief key of an element for 'sort_radix_by_key', elements are sorted by increasing key
+*/
+typedef uint64_t(*sortKeyFunc)(const void *element);
+
+// ------------------------------------------------------------ Radix sort ---------------------------------------------------------
+
+/**
+ * @brief sort in increasing order
+ * @attention O(n), allocates a buffer of 'size' elements
+*/
+void sort_radix_u32(uint32_t *data, size_t size);
+
+/**
+ * @brief sort in increasing order
+ * @attention O(n), allocates a buffer of 'size' elements
+*/
+void sort_radix_u64(uint64_t *data, size_t size);
+
+/**
+ * @brief sort in increasing order
+ * @attention O(n), allocates a buffer of 'size' elements
+*/
+void sort_radix_i64(int64_t *data, size_t size);
+
+/**
+ * @brief stable sort of an array of 'size' elements of 'elementSize' bytes by an integer key.
+ * Keys are extracted once, sorted with the element positions, and the elements are moved once at the end
+ * @attention O(n), allocates buffers of 'size' keys and 'size' elements
+*/
+void sort_radix_by_key(void *data, size_t size, size_t elementSize, sortKeyFunc key);
+
+// ------------------------------------------------------------ Merge sort ---------------------------------------------------------
+
+/**
+ * @brief stable sort of an array of pointers
+ * @param threads: number of threads, 0 for the number of processors. Small arrays are sorted by the calling thread
+ * @attention O(n log n), allocates a buffer of 'size' pointers
+*/
+void sort_pointers(void **values, size_t size, orderFunc order, size_t threads);
+
+/**
+ * @brief stable sort of the values of an array, same as 'sort_pointers'
+*/
+void sort_array(array_t *a, orderFunc order, size_t threads);
+
+/**
+ * @brief stable sort of the values of a list, from first to last. The values are moved, nodes stay in place
+ * @attention O(n log n), allocates a buffer of 'size' pointers
+*/
+void sort_list(list_t *l, orderFunc order);
+
+// ------------------------------------------------------------ Comparison sort ----------------------------------------------------
+
+/**
+ * @brief define 'void name(T *data, size_t size)', an unstable in place sort in increasing order.
+ * Introsort: quicksort with a median of three pivot, insertion sort on small ranges,
+ * and heapsort when the recursion gets too deep, so it's O(n log n) in the worst case
+ * @param less: function or macro taking two 'T' and returning true when the first goes before the second.
+ * A macro may evaluate it's arguments more than once, they are never expressions with side effects
+*/
+#define SORT_DEFINE(name, T, less)																				\
+																												\
+static inline void name##_insertion(T *data, size_t size){														\
+	for(size_t i = 1; i < size; i++){																			\
+		T value = data[i];																						\
+		size_t j = i;																							\
+		for(; j > 0 && less(value, data[j - 1]); j--)															\
+			data[j] = data[j - 1];																				\
+		data[j] = value;																						\
+	}																											\
+}																												\
+																												\
+static inline void name##_sift(T *data, size_t i, size_t size){													\
+	T value = data[i];																							\
+	for(size_t child; (child = 2 * i + 1) < size; i = child){													\
+		if(child + 1 < size && less(data[child], data[child + 1])) child++;										\
+		if(!less(value, data[child])) break;																	\
+		data[i] = data[child];																					\
+	}																											\
+	data[i] = value;																							\
+}																												\
+																												\
+static inline void name##_heapsort(T *data, size_t size){														\
+	for(size_t i = size / 2; i-- > 0;)																			\
+		name##_sift(data, i, size);																				\
+	for(size_t end = size; end-- > 1;){																			\
+		T t = data[0]; data[0] = data[end]; data[end] = t;														\
+		name##_sift(data, 0, end);																				\
+	}																											\
+}																												\
+																												\
+static inline void name##_swap(T *a, T *b){																		\
+	T t = *a; *a = *b; *b = t;																					\
+}																												\
+																												\
+static void name##_intro(T *data, size_t size, size_t depth){													\
+	while(size > SORT_SMALL){																					\
+		if(depth-- == 0){																						\
+			name##_heapsort(data, size);																		\
+			return;																								\
+		}																										\
+																												\
+		/* median of three to the front, it's the pivot and the sentinels end up on both sides */				\
+		size_t mid = size / 2;																					\
+		if(less(data[mid], data[0])) name##_swap(&data[mid], &data[0]);											\
+		if(less(data[size - 1], data[mid])) name##_swap(&data[size - 1], &data[mid]);							\
+		if(less(data[mid], data[0])) name##_swap(&data[mid], &data[0]);											\
+		name##_swap(&data[0], &data[mid]);																		\
+																												\
+		/* Hoare partition around data[0] */																	\
+		T pivot = data[0];																						\
+		size_t i = 0;																							\
+		size_t j = size;																						\
+		for(;;){																								\
+			do i++; while(less(data[i], pivot));																\
+			do j--; while(less(pivot, data[j]));																\
+			if(i >= j) break;																					\
+			name##_swap(&data[i], &data[j]);																	\
+		}																										\
+		name##_swap(&data[0], &data[j]);																		\
+																												\
+		/* recurse into the smaller side, loop on the bigger one */												\
+		if(j < size - j - 1){																					\
+			name##_intro(data, j, depth);																		\
+			data += j + 1;																						\
+			size -= j + 1;																						\
+		}else{																									\
+			name##_intro(data + j + 1, size - j - 1, depth);													\
+			size = j;																							\
+		}																										\
+	}																											\
+	name##_insertion(data, size);																				\
+}																												\
+																												\
+static inline void name(T *data, size_t size){																	\
+	size_t depth = 0;																							\
+	for(size_t n = size; n > 1; n >>= 1)																		\
+		depth += 2;																								\
+	name##_intro(data, size, depth);																			\
+}
+
+#endif
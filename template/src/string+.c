@@ -2,6 +2,15 @@
 #include "regex.h"
 #include "ctype.h"
 #include <errno.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /**
  * !Obs:
@@ -13,27 +22,77 @@
 
 // !trivial
 string *string_new_sized(size_t size){
-	string *str = calloc(sizeof(char), sizeof(string));
+	// header and buffer in a single allocation, the buffer moves out when the string grows
+	string *str = calloc(1, sizeof(string) + size);
 	str->len = 0;
 	str->allocated = size;
 	str->owns = true;
+	str->inlined = size > 0;
+	str->raw = size > 0 ? (char*)(str + 1) : NULL;
+	return str;
+}
 
-	if(str->allocated > 0 )
-		str->raw = calloc(str->allocated, sizeof(char));
-	else
-		str->raw = NULL;
+// !trivial
+string string_with_buffer(char *buffer, size_t size){
+	if(buffer != NULL && size > 0)
+		buffer[0] = '\0';
 
-	return str;
+	return (string){
+		.raw = buffer,
+		.len = 0,
+		.allocated = buffer != NULL ? size : 0,
+		.owns = true,
+		.inlined = buffer != NULL
+	};
+}
+
+void string_free(string *str){
+	if(str->owns && !str->inlined && !str->mapped && str->arena == NULL)
+		free(str->raw);
+
+	*str = (string){0};
 }
 
 string *string_new(){
 	return string_new_sized(STRING_ALLOCATION_CHUNK);
 }
 
+// !trivial
+string *string_new_arena(arena_t *arena, size_t size){
+	string *str = arena_calloc(arena, 1, sizeof(string));
+	str->arena = arena;
+	str->owns = true;
+	str->allocated = size > 0 ? size : 1;
+	str->raw = arena_alloc(arena, str->allocated);
+	str->raw[0] = '\0';
+	return str;
+}
+
+// !trivial
+string *string_from_arena(arena_t *arena, const char *raw){
+	if(raw == NULL) return NULL;
+	size_t len = strlen(raw);
+	string *str = string_new_arena(arena, len + 1);
+	str->len = len;
+	memcpy(str->raw, raw, len + 1);
+	return str;
+}
+
+// !trivial
+string *string_copy_arena(arena_t *arena, const string *str){
+	if(str == NULL) return NULL;
+	string *new = string_new_arena(arena, str->len + 1);
+	new->len = str->len;
+	memcpy(new->raw, str->raw, str->len);
+	new->raw[new->len] = '\0';
+	return new;
+}
+
 // !trivial
 string *string_copy(const string *str){
 	if(str == NULL) return NULL;
-	string *new = string_new_sized(str->allocated);
+	// wrapped and mapped strings have no allocated size
+	string *new = string_new_sized(str->allocated > str->len ? str->allocated : str->len + 1);
 	new->len = str->len;
 	memcpy(new->raw, str->raw, str->len);
 	return new;
@@ -54,18 +113,17 @@ string *string_wrap(char *raw, bool take_ownership){
 	if(raw == NULL) return NULL;
 	size_t len = strlen(raw);
 	string *str = malloc(sizeof(string));
-	str->allocated = 0;
-	str->owns = take_ownership;
-	str->len = len;
-	str->raw = raw;
+	*str = (string){
+		.raw = raw,
+		.len = len,
+		.owns = take_ownership
+	};
 	return str;
 }
 
 string *string_vsprint(const char *fmt, size_t max_size, va_list args){
-	char *buffer = malloc(max_size);
-	vsnprintf(buffer, max_size, fmt, args);
-	string *str = string_from(buffer);
-	free(buffer);
+	string *str = string_new_sized(max_size > 0 ? max_size : 1);
+	string_vwrite(str, fmt, max_size, args);
 	return str;
 }
 
@@ -78,7 +136,12 @@ string *string_sprint(const char *fmt, size_t max_size, ...){
 }
 
 void string_destroy(string *str){
-	if(str->owns)
+	// released with the arena
+	if(str->arena != NULL) return;
+
+	if(str->mapped)
+		munmap(str->raw, str->len + 1);
+	else if(str->owns && !str->inlined)
 		free(str->raw);
 
 	free(str);
@@ -86,7 +149,16 @@ void string_destroy(string *str){
 
 char *string_unwrap(string *str){
 	char *raw = str->raw;
-	free(str);
+
+	// the buffer is part of the header allocation
+	if(str->inlined && str->arena == NULL){
+		raw = malloc(str->len + 1);
+		memcpy(raw, str->raw, str->len);
+		raw[str->len] = '\0';
+	}
+
+	if(str->arena == NULL)
+		free(str);
 	return raw;
 }
 
@@ -141,27 +213,42 @@ bool string_cmp(const string *a, const string *b){
 	return string_cmp_raw(a, b->raw);
 }
 
+// !trivial
+bool string_reserve(string *str, size_t size){
+	// slices and mapped strings can't grow
+	if(str->allocated == 0 && str->owns == false) return false;
+	// + 1 for the null terminator
+	if(str->allocated >= size + 1) return true;
+
+	size_t allocated = str->allocated > 0 ? str->allocated : STRING_ALLOCATION_CHUNK;
+	while(allocated < size + 1)
+		allocated *= 2;
+
+	// wrapped strings are always malloc'd, so they can be realloc'd too
+	if(str->arena != NULL)
+		str->raw = arena_realloc(str->arena, str->raw, str->allocated, allocated);
+	else if(str->inlined){
+		// move out of the header or caller buffer
+		char *raw = malloc(allocated);
+		memcpy(raw, str->raw, str->len);
+		raw[str->len] = '\0';
+		str->raw = raw;
+		str->inlined = false;
+	}
+	else
+		str->raw = realloc(str->raw, allocated);
+	str->allocated = allocated;
+	return true;
+}
+
 // !trivial
 void _string_cat_raw(string * restrict dest, const char * restrict src, size_t srclen){
 	// no src or dest is string slice
-	if(src == NULL || (dest->allocated == 0 && dest->owns == false)) return;
+	if(src == NULL || !string_reserve(dest, dest->len + srclen)) return;
 
-	size_t len = dest->len + srclen;
-	if(dest->allocated == 0){
-		dest->allocated = len + STRING_ALLOCATION_CHUNK;
-		dest->raw = calloc(dest->allocated, sizeof(char));
-		dest->len = len;
-		memcpy(dest->raw, src, len);	
-	}
-	else{
-		if(dest->allocated < (len + 1)){
-			dest->allocated = len + STRING_ALLOCATION_CHUNK; // add more just in case
-			dest->raw = realloc(dest->raw, dest->allocated);
-		}
-
-		dest->len = len;
-		strncat(dest->raw, src, srclen);
-	}
+	memcpy(dest->raw + dest->len, src, srclen);
+	dest->len += srclen;
+	dest->raw[dest->len] = '\0';
 }
 
 void string_cat_raw(string * restrict dest, const char * restrict src, size_t len){
@@ -182,11 +269,19 @@ void string_cat(string * restrict dest, const string * restrict src, size_t len)
 	_string_cat_raw(dest, src->raw, l);
 }
 
+// !trivial
 void string_vwrite(string *str, const char *fmt, size_t buffer_size, va_list args){
-	if(buffer_size == 0) return;
-	string *expanded = string_vsprint(fmt, buffer_size, args);
-	string_cat(str, expanded, 0);
-	string_destroy(expanded);
+	// format straight into the tail of the string
+	if(buffer_size == 0 || !string_reserve(str, str->len + buffer_size - 1)) return;
+
+	int written = vsnprintf(str->raw + str->len, buffer_size, fmt, args);
+	if(written < 0){
+		str->raw[str->len] = '\0';
+		return;
+	}
+
+	// truncated to the buffer size
+	str->len += (size_t)written < buffer_size ? (size_t)written : buffer_size - 1;
 }
 
 void string_vwriteLn(string *str, const char *fmt, size_t buffer_size, va_list args){
@@ -210,24 +305,56 @@ void string_writeLn(string *str, const char *fmt, size_t buffer_size, ...){
 	va_end(args);
 }
 
+// !trivial
+char *_string_read_stream(FILE *file, size_t *size){
+	size_t allocated = STRING_READ_CHUNK;
+	size_t len = 0;
+	char *buffer = malloc(allocated);
+
+	size_t got;
+	while((got = fread(buffer + len, sizeof(char), allocated - len - 1, file)) > 0){
+		len += got;
+
+		if(allocated - len - 1 == 0){
+			allocated *= 2;
+			buffer = realloc(buffer, allocated);
+		}
+	}
+
+	buffer[len] = 0;
+	*size = len;
+	return buffer;
+}
+
 string *string_from_file(FILE *file, size_t *read){
     if(file == NULL) return NULL;
 
-    fseek(file, 0, SEEK_END);
-    size_t size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    char *buffer;
+    size_t size;
 
-    char *buffer = (char*)malloc(size + 1);
-    fread(buffer, size, 1, file);
+    // pipes can't be seeked, so read them in chunks
+    long end = -1;
+    if(fseek(file, 0, SEEK_END) == 0)
+        end = ftell(file);
 
-    fclose(file);
+    if(end < 0 || fseek(file, 0, SEEK_SET) != 0){
+        buffer = _string_read_stream(file, &size);
+    }
+    else{
+        size = end;
+        buffer = (char*)malloc(size + 1);
+        size = fread(buffer, sizeof(char), size, file);
+        buffer[size] = 0;
+    }
 
-    buffer[size] = 0;
+    fclose(file);
 
     if(read != NULL)
         *read = size;
 
-    return string_wrap(buffer, true);
+    string *str = string_wrap(buffer, true);
+    str->len = size;
+    return str;
 }
 
 string *string_from_filename(const char *filename, size_t *read){
@@ -237,43 +364,325 @@ string *string_from_filename(const char *filename, size_t *read){
     return string_from_file(file, read);
 }
 
+// !trivial
+string *string_map_filename(const char *filename, size_t *read, string_map_flags_t flags){
+	int fd = open(filename, O_RDONLY);
+	if(fd < 0) return NULL;
+
+	struct stat st;
+	if(fstat(fd, &st) < 0){
+		close(fd);
+		return NULL;
+	}
+
+	// pipes and devices can't be mapped and /proc files report a size of 0, read them as a stream.
+	// An empty regular file reads as an empty string too
+	if(!S_ISREG(st.st_mode) || st.st_size == 0){
+		FILE *file = fdopen(fd, "rb");
+		if(file == NULL){
+			close(fd);
+			return NULL;
+		}
+
+		size_t size;
+		char *buffer = _string_read_stream(file, &size);
+		fclose(file);
+
+		if(read != NULL) *read = size;
+		string *str = string_wrap(buffer, true);
+		str->len = size;
+		return str;
+	}
+
+	size_t size = st.st_size;
+
+	// reserve one byte more than the file as anonymous zeroed memory, then map the file over it.
+	// Reading right past the file then hits the zero page and not past the mapping, so the string is always null terminated
+	char *raw = mmap(NULL, size + 1, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(raw == MAP_FAILED){
+		close(fd);
+		return NULL;
+	}
+
+	int mapFlags = MAP_PRIVATE | MAP_FIXED;
+	#ifdef MAP_POPULATE
+	if(flags & string_map_populate)
+		mapFlags |= MAP_POPULATE;
+	#endif
+
+	if(mmap(raw, size, PROT_READ, mapFlags, fd, 0) == MAP_FAILED){
+		munmap(raw, size + 1);
+		close(fd);
+		return NULL;
+	}
+
+	close(fd);
+
+	if(flags & string_map_sequential)
+		madvise(raw, size, MADV_SEQUENTIAL);
+
+	if(read != NULL)
+		*read = size;
+
+	string *str = malloc(sizeof(string));
+	*str = (string){
+		.raw = raw,
+		.len = size,
+		.mapped = true
+	};
+	return str;
+}
+
+static inline bool string_ite_is_token(const string_ite *iterator, unsigned char c){
+	return (iterator->set[c >> 6] >> (c & 63)) & 1;
+}
+
+// !trivial
+static const char *string_ite_find_token(const string_ite *iterator, const char *cursor, const char *end){
+	switch(iterator->delimitersSize){
+		case 1:{
+			const char *found = memchr(cursor, iterator->delimiters[0], end - cursor);
+			return found != NULL ? found : end;
+		}
+
+		#ifdef __SSE2__
+		case 2:
+		case 3:
+		case 4:{
+			// unused lanes repeat the first token
+			__m128i d0 = _mm_set1_epi8(iterator->delimiters[0]);
+			__m128i d1 = _mm_set1_epi8(iterator->delimiters[1]);
+			__m128i d2 = _mm_set1_epi8(iterator->delimiters[2]);
+			__m128i d3 = _mm_set1_epi8(iterator->delimiters[3]);
+
+			for(; cursor + 16 <= end; cursor += 16){
+				__m128i chunk = _mm_loadu_si128((const __m128i*)cursor);
+				__m128i eq = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, d0), _mm_cmpeq_epi8(chunk, d1)),
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, d2), _mm_cmpeq_epi8(chunk, d3))
+				);
+
+				int mask = _mm_movemask_epi8(eq);
+				if(mask != 0)
+					return cursor + __builtin_ctz(mask);
+			}
+			break;
+		}
+		#endif
+
+		default:
+			break;
+	}
+
+	while(cursor < end && !string_ite_is_token(iterator, *cursor))
+		cursor++;
+
+	return cursor;
+}
+
 // !trivial
 string string_ite_next(string_ite *iterator){
-	size_t start = strspn(iterator->state, iterator->tokens);
-	size_t end = strcspn(iterator->state + start, iterator->tokens);
+	const char *end = iterator->base + iterator->max;
+	const char *start = iterator->state;
+
+	// skip leading tokens
+	while(start < end && string_ite_is_token(iterator, *start))
+		start++;
 
 	// no more string
-	if(end == 0 || iterator->state + start >= iterator->base + iterator->max){
+	if(start >= end){
 		iterator->yield = false;
 		return (string){0};
 	}
 
-	// string ended
-	if(iterator->state + start + end > iterator->base + iterator->max){
-		// correct end to the base max
-		end = iterator->base + iterator->max - (iterator->state + start);
-	}
+	const char *tokenEnd = string_ite_find_token(iterator, start + 1, end);
 	
 	string slice = (string){
-		.raw = iterator->state + start,
-		.len = end,
+		.raw = (char*)start,
+		.len = tokenEnd - start,
 		.allocated = 0,
 		.owns = false
 	};
 
-	iterator->state += start + end;
+	iterator->state = (char*)tokenEnd;
 	return slice; 
 }
 
+// !trivial
 string_ite string_split(const string *str, const char *tokens){
-	return (string_ite){
+	string_ite ite = (string_ite){
 		.state = str->raw,
 		.base = str->raw,
 		.max = str->len,
 		.tokens = tokens,
 		.next = string_ite_next,
-		.yield = true
+		.yield = true,
+		.set = {0},
+		.delimitersSize = 0
 	};
+
+	size_t count = 0;
+	for(const unsigned char *t = (const unsigned char*)tokens; *t != '\0'; t++){
+		if(!string_ite_is_token(&ite, *t))
+			count++;
+
+		ite.set[*t >> 6] |= 1ULL << (*t & 63);
+	}
+
+	if(count > 0 && count <= STRING_SPLIT_FAST_TOKENS){
+		for(size_t c = 0, i = 0; c < 256; c++){
+			if(string_ite_is_token(&ite, c))
+				ite.delimiters[i++] = c;
+		}
+
+		for(size_t i = count; i < STRING_SPLIT_FAST_TOKENS; i++)
+			ite.delimiters[i] = ite.delimiters[0];
+
+		ite.delimitersSize = count;
+	}
+
+	return ite;
+}
+
+// !trivial
+string string_file_ite_next(string_file_ite *iterator){
+	if(iterator->buffer == NULL){
+		iterator->yield = false;
+		return (string){0};
+	}
+
+	while(true){
+		// a full line in the buffer
+		char *nl = memchr(iterator->buffer + iterator->start, '\n', iterator->end - iterator->start);
+		if(nl != NULL){
+			string line = (string){
+				.raw = iterator->buffer + iterator->start,
+				.len = nl - (iterator->buffer + iterator->start),
+				.allocated = 0,
+				.owns = false
+			};
+
+			iterator->start += line.len + 1;
+			return line;
+		}
+
+		// last line without a line ending
+		if(iterator->eof){
+			if(iterator->start < iterator->end){
+				string line = (string){
+					.raw = iterator->buffer + iterator->start,
+					.len = iterator->end - iterator->start,
+					.allocated = 0,
+					.owns = false
+				};
+
+				iterator->start = iterator->end;
+				return line;
+			}
+
+			string_file_lines_close(iterator);
+			return (string){0};
+		}
+
+		// carry over partial line to the start of the buffer
+		size_t partial = iterator->end - iterator->start;
+		memmove(iterator->buffer, iterator->buffer + iterator->start, partial);
+		iterator->start = 0;
+		iterator->end = partial;
+
+		// line bigger than the buffer
+		if(iterator->end == iterator->allocated){
+			iterator->allocated *= 2;
+			iterator->buffer = realloc(iterator->buffer, iterator->allocated);
+		}
+
+		size_t got = fread(iterator->buffer + iterator->end, sizeof(char), iterator->allocated - iterator->end, iterator->file);
+		iterator->end += got;
+		if(got == 0)
+			iterator->eof = true;
+	}
+}
+
+string_file_ite string_file_lines(FILE *file){
+	return (string_file_ite){
+		.next = string_file_ite_next,
+		.yield = file != NULL,
+		.file = file,
+		.buffer = file != NULL ? malloc(STRING_READ_CHUNK) : NULL,
+		.allocated = STRING_READ_CHUNK,
+		.start = 0,
+		.end = 0,
+		.eof = false
+	};
+}
+
+void string_file_lines_close(string_file_ite *iterator){
+	free(iterator->buffer);
+	iterator->buffer = NULL;
+	iterator->yield = false;
+}
+
+static inline void string_lines_push(string_lines_t *lines, size_t *allocated, size_t start){
+	if(lines->count + 1 >= *allocated){
+		*allocated *= 2;
+		lines->starts = realloc(lines->starts, *allocated * sizeof(size_t));
+	}
+
+	lines->starts[lines->count++] = start;
+}
+
+// !trivial
+string_lines_t string_lines_index(const string *str){
+	string_lines_t lines = {.base = str->raw, .count = 0};
+	size_t allocated = STRING_ALLOCATION_CHUNK;
+	lines.starts = malloc(allocated * sizeof(size_t));
+
+	if(str->len > 0)
+		string_lines_push(&lines, &allocated, 0);
+
+	size_t i = 0;
+	#ifdef __SSE2__
+	// compare 16 bytes at a time, every set bit of the mask is a '\n'
+	const __m128i newline = _mm_set1_epi8('\n');
+	for(; i + 16 <= str->len; i += 16){
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(str->raw + i));
+		unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		while(mask){
+			string_lines_push(&lines, &allocated, i + __builtin_ctz(mask) + 1);
+			mask &= mask - 1;
+		}
+	}
+	#endif
+
+	for(; i < str->len; i++){
+		if(str->raw[i] == '\n')
+			string_lines_push(&lines, &allocated, i + 1);
+	}
+
+	// a '\n' at the end doesn't start a line, it's start is kept as the end sentinel
+	if(lines.count > 0 && lines.starts[lines.count - 1] == str->len)
+		lines.count--;
+	else
+		lines.starts[lines.count] = str->len + 1;
+
+	return lines;
+}
+
+string string_lines_at(const string_lines_t *lines, size_t n){
+	if(n >= lines->count) return (string){0};
+
+	return (string){
+		.raw = (char*)lines->base + lines->starts[n],
+		.len = lines->starts[n + 1] - lines->starts[n] - 1,
+		.allocated = 0,
+		.owns = false
+	};
+}
+
+void string_lines_destroy(string_lines_t *lines){
+	free(lines->starts);
+	lines->starts = NULL;
+	lines->count = 0;
 }
 
 // !trivial
@@ -293,22 +702,117 @@ string string_slice(const string *str, int from, unsigned int len){
 	};
 }
 
+// copy a number prefix of a slice to a null terminated buffer, so strtol and friends don't read past the slice
+static const char *string_number_prefix(const string *str, char *buffer, size_t size){
+	size_t len = str->len < size - 1 ? str->len : size - 1;
+	memcpy(buffer, str->raw, len);
+	buffer[len] = '\0';
+	return buffer;
+}
+
 int64_t string_to_int(const string *str, uint32_t base){
 	if(str == NULL) return 0;
 
-	return strtol(str->raw, NULL, base);
+	char buffer[STRING_NUMBER_MAX_SIZE];
+	return strtol(string_number_prefix(str, buffer, STRING_NUMBER_MAX_SIZE), NULL, base);
 }
 
 uint64_t string_to_uint(const string *str, uint32_t base){
 	if(str == NULL) return 0;
 
-	return strtoul(str->raw, NULL, base);
+	char buffer[STRING_NUMBER_MAX_SIZE];
+	return strtoul(string_number_prefix(str, buffer, STRING_NUMBER_MAX_SIZE), NULL, base);
 }
 
 double string_to_double(const string *str){
 	if(str == NULL) return 0;
 
-	return strtod(str->raw, NULL);
+	char buffer[STRING_NUMBER_MAX_SIZE];
+	return strtod(string_number_prefix(str, buffer, STRING_NUMBER_MAX_SIZE), NULL);
+}
+
+static inline bool string_is_digit(char c){
+	return (unsigned char)(c - '0') < 10;
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// SWAR, true if all 8 bytes are ascii digits
+static inline bool string_is_8_digits(uint64_t chunk){
+	return (((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333);
+}
+
+// SWAR, convert 8 ascii digits to their value, first character is the most significant
+static inline uint64_t string_parse_8_digits(uint64_t chunk){
+	chunk -= 0x3030303030303030;
+	chunk = (chunk * 10) + (chunk >> 8);
+	return (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+}
+#endif
+
+// !trivial
+// parses the next integer between 'cursor' and 'end'. Returns false if there are no more digits
+static inline bool string_next_int(const char *base, const char **cursor, const char *end, int64_t *value){
+	const char *c = *cursor;
+	while(c < end && !string_is_digit(*c))
+		c++;
+
+	if(c >= end){
+		*cursor = end;
+		return false;
+	}
+
+	bool negative = c > base && c[-1] == '-';
+	uint64_t acc = 0;
+
+	#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	while(c + 8 <= end){
+		uint64_t chunk;
+		memcpy(&chunk, c, 8);
+		if(!string_is_8_digits(chunk)) break;
+		acc = acc * 100000000 + string_parse_8_digits(chunk);
+		c += 8;
+	}
+	#endif
+
+	while(c < end && string_is_digit(*c)){
+		acc = acc * 10 + (*c - '0');
+		c++;
+	}
+
+	*cursor = c;
+	// negated as unsigned, -(int64_t)acc overflows for INT64_MIN
+	*value = (int64_t)(negative ? 0 - acc : acc);
+	return true;
+}
+
+size_t string_parse_ints(const string *str, int64_t *out, size_t max){
+	if(str == NULL || out == NULL) return 0;
+
+	const char *cursor = str->raw;
+	const char *end = str->raw + str->len;
+	size_t count = 0;
+	while(count < max && string_next_int(str->raw, &cursor, end, &out[count]))
+		count++;
+
+	return count;
+}
+
+int64_t string_int_ite_next(string_int_ite *iterator){
+	int64_t value = 0;
+	if(!string_next_int(iterator->base, &iterator->state, iterator->end, &value))
+		iterator->yield = false;
+
+	return value;
+}
+
+string_int_ite string_ints(const string *str){
+	return (string_int_ite){
+		.next = string_int_ite_next,
+		.yield = true,
+		.base = str->raw,
+		.state = str->raw,
+		.end = str->raw + str->len
+	};
 }
 
 int getGroupId(char *replaceExpression, char **groupIdStart, char** groupIdEnd){
@@ -328,122 +832,454 @@ int getGroupId(char *replaceExpression, char **groupIdStart, char** groupIdEnd){
 	return -1;
 }
 
-typedef struct{
-	string *replaced;
-	string **matches;
-	size_t matchesSize;
-}matches_and_replaced_t;
+// ------------------------------------------------------------ Regex --------------------------------------------------------------
 
 // !trivial
-matches_and_replaced_t _string_match_replace_all(const string *str, const char *regex, const char *replace, size_t max, bool storeMatches, bool processReplace, error_t *err){
-	regex_t reg;
-	int res;
+// 'regcomp' reads '\d', '\w' and '\s' as the letters themselves, rewrite them as bracket expressions.
+// Inside brackets backslashes are already literal in both engines, so those are copied as they are
+static char *string_regex_to_posix(const char *regex){
+	static const struct{
+		char escape;
+		const char *bracket;
+	}shorthands[] = {
+		{'d', "[[:digit:]]"}, {'D', "[^[:digit:]]"},
+		{'w', "[[:alnum:]_]"}, {'W', "[^[:alnum:]_]"},
+		{'s', "[[:space:]]"}, {'S', "[^[:space:]]"},
+	};
+
+	// the longest rewrite is 13 bytes for 2
+	char *posix = malloc(strlen(regex) * 7 + 1);
+	char *out = posix;
+	const char *c = regex;
+	while(*c != '\0'){
+		if(*c == '['){
+			// copy the bracket expression, a ']' right after '[' or '[^' is part of it
+			*out++ = *c++;
+			if(*c == '^') *out++ = *c++;
+			if(*c == ']') *out++ = *c++;
+			while(*c != '\0' && *c != ']'){
+				// '[:class:]', '[.x.]' and '[=x=]' end with their own ']'
+				if(c[0] == '[' && (c[1] == ':' || c[1] == '.' || c[1] == '=')){
+					char delimiter = c[1];
+					*out++ = *c++;
+					*out++ = *c++;
+					while(*c != '\0' && !(c[0] == delimiter && c[1] == ']'))
+						*out++ = *c++;
+					if(*c != '\0'){
+						*out++ = *c++;
+						*out++ = *c++;
+					}
+					continue;
+				}
+				*out++ = *c++;
+			}
+			if(*c == ']') *out++ = *c++;
+			continue;
+		}
+
+		if(c[0] == '\\' && c[1] != '\0'){
+			const char *bracket = NULL;
+			for(size_t i = 0; i < sizeof(shorthands) / sizeof(*shorthands); i++)
+				if(shorthands[i].escape == c[1])
+					bracket = shorthands[i].bracket;
+
+			if(bracket != NULL){
+				size_t len = strlen(bracket);
+				memcpy(out, bracket, len);
+				out += len;
+			}
+			else{
+				*out++ = c[0];
+				*out++ = c[1];
+			}
+			c += 2;
+			continue;
+		}
 
-	// reg compile
-	if((res = regcomp(&reg, regex, REG_EXTENDED | REG_NEWLINE))){
+		*out++ = *c++;
+	}
+
+	*out = '\0';
+	return posix;
+}
+
+// !trivial
+string_regex_t *string_regex_compile(const char *regex, error_t *err){
+	if(regex == NULL) return NULL;
+
+	string_regex_t *re = calloc(1, sizeof(string_regex_t));
+	re->pattern = strdup(regex);
+
+	// built in engine first
+	re->dfa = regex_dfa_compile(regex);
+	if(re->dfa != NULL){
+		re->groups = regex_dfa_groups(re->dfa);
+		if(err != NULL) *err = (error_t){.code = 0, .msg = "ok"};
+		return re;
+	}
+
+	char *posix = string_regex_to_posix(regex);
+	int res = regcomp(&re->reg, posix, REG_EXTENDED | REG_NEWLINE);
+	free(posix);
+	if(res){
 		if(err != NULL){
 			err->code = res;
-			regerror(res, &reg, (char*)err->msg, 300);
+			regerror(res, &re->reg, (char*)err->msg, 300);
 		} 
-		return (matches_and_replaced_t){0};
+
+		free(re->pattern);
+		free(re);
+		return NULL;
 	}
 
-	regmatch_t groups[100];
+	re->groups = re->reg.re_nsub + 1;
+	if(err != NULL) *err = (error_t){.code = 0, .msg = "ok"};
+	return re;
+}
 
-	matches_and_replaced_t ret = {
-		.replaced = processReplace ? string_new_sized(str->len + STRING_ALLOCATION_CHUNK) : NULL,
-		.matches = storeMatches ? calloc(max, sizeof(string*)) : NULL,
-		.matchesSize = 0
-	};
+void string_regex_destroy(string_regex_t *re){
+	if(re == NULL) return;
 
-	// match again and again 
-	char *cursor = str->raw;
-	for(size_t m = 0; (max == 0 || m < max) && (cursor < (str->raw + str->len)); m++){
-        if((res = regexec(&reg, cursor, 100, groups, 0))){
-			if(err != NULL){
-				err->code = res;
-				regerror(res, &reg, (char*)err->msg, 300);
-			} 
-			
-			// append rest on exit
-			if(processReplace)
-				string_cat_raw(ret.replaced, cursor, 0);
+	if(re->dfa != NULL)
+		regex_dfa_destroy(re->dfa);
+	else
+		regfree(&re->reg);
 
-			break;
+	free(re->pattern);
+	free(re);
+}
+
+// LRU cache of compiled patterns, keyed by the pattern string
+static struct{
+	pthread_mutex_t lock;
+	hashtable_t *index;										// pattern -> entry position + 1
+	string_regex_t *entries[STRING_REGEX_CACHE_SIZE];
+	uint64_t lastUse[STRING_REGEX_CACHE_SIZE];
+	uint64_t tick;
+}regexCache = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// !trivial
+static string_regex_t *string_regex_cache_acquire(const char *regex, error_t *err){
+	pthread_mutex_lock(&regexCache.lock);
+
+	if(regexCache.index == NULL)
+		regexCache.index = hashtable_new(STRING_REGEX_CACHE_SIZE * 4);
+
+	size_t pos = (size_t)hashtable_get(regexCache.index, (char*)regex);
+	string_regex_t *re;
+
+	// hit
+	if(pos > 0){
+		pos--;
+		re = regexCache.entries[pos];
+	}
+	// miss
+	else{
+		re = string_regex_compile(regex, err);
+		if(re == NULL){
+			pthread_mutex_unlock(&regexCache.lock);
+			return NULL;
 		}
 
-		// groups
-		int groupSize = 0;
-		for(size_t i = 0; i < 100; i++){
-			if(groups[i].rm_so == -1) break;
-			
-			// correct offsets
-			// groups[i].rm_so += cursor - str->raw;
-			// groups[i].rm_eo += cursor - str->raw;
+		// free or least recently used position
+		pos = 0;
+		for(size_t i = 0; i < STRING_REGEX_CACHE_SIZE; i++){
+			if(regexCache.entries[i] == NULL){
+				pos = i;
+				break;
+			}
 
-			groupSize++;	
+			if(regexCache.lastUse[i] < regexCache.lastUse[pos])
+				pos = i;
 		}
 
-		if(processReplace){
-			// add original string
-			string_cat_raw(ret.replaced, cursor, groups[0].rm_so);
+		// evict, in use regexes are freed by the last one to release them
+		string_regex_t *evicted = regexCache.entries[pos];
+		if(evicted != NULL){
+			hashtable_remove(regexCache.index, evicted->pattern);
+			evicted->cached = false;
+			if(evicted->refs == 0)
+				string_regex_destroy(evicted);
+		}
 
-			// substitute groups
-			char *replaceCursor = (char*)replace;
-			char *endText;
-			char *end;
-			int id = getGroupId(replaceCursor, &endText, &end);
-			while(replaceCursor != NULL){
-				string_cat_raw(ret.replaced, (const char *)replaceCursor, endText - replaceCursor);
+		re->cached = true;
+		regexCache.entries[pos] = re;
+		hashtable_set(regexCache.index, re->pattern, (void*)(pos + 1));
+	}
 
-				if(id > -1 && id < groupSize)
-					string_cat_raw(ret.replaced, cursor + groups[id].rm_so, groups[id].rm_eo - groups[id].rm_so);
+	regexCache.lastUse[pos] = ++regexCache.tick;
+	re->refs++;
 
-				replaceCursor = end;
-				id = getGroupId(replaceCursor, &endText, &end);
-			}
+	pthread_mutex_unlock(&regexCache.lock);
+	if(err != NULL) *err = (error_t){.code = 0, .msg = "ok"};
+	return re;
+}
+
+static void string_regex_cache_release(string_regex_t *re){
+	pthread_mutex_lock(&regexCache.lock);
+	re->refs--;
+	if(!re->cached && re->refs == 0)
+		string_regex_destroy(re);
+	pthread_mutex_unlock(&regexCache.lock);
+}
+
+// !trivial
+void string_regex_cache_clear(void){
+	pthread_mutex_lock(&regexCache.lock);
+	for(size_t i = 0; i < STRING_REGEX_CACHE_SIZE; i++){
+		string_regex_t *re = regexCache.entries[i];
+		if(re == NULL) continue;
+
+		re->cached = false;
+		if(re->refs == 0)
+			string_regex_destroy(re);
+
+		regexCache.entries[i] = NULL;
+		regexCache.lastUse[i] = 0;
+	}
+
+	if(regexCache.index != NULL)
+		hashtable_destroy(regexCache.index);
+
+	regexCache.index = NULL;
+	pthread_mutex_unlock(&regexCache.lock);
+}
+
+// !trivial
+static int string_regex_exec(const string_regex_t *re, const char *cursor, size_t len, regmatch_t *groups, error_t *err){
+	int res;
+	if(re->dfa != NULL){
+		res = regex_dfa_exec(re->dfa, cursor, len, re->groups, groups);
+		if(res && err != NULL){
+			err->code = res;
+			strcpy(err->msg, "No match");
 		}
 
-		if(storeMatches){
-			// store matched
-			ret.matches[ret.matchesSize] = string_wrap(cursor + groups[0].rm_so, false);
-			ret.matches[ret.matchesSize]->len = groups[0].rm_eo - groups[0].rm_so;
-			ret.matchesSize++;
+		return res;
+	}
+
+	int flags = 0;
+
+	// bound the search to the string length, slices aren't null terminated
+	#ifdef REG_STARTEND
+	groups[0].rm_so = 0;
+	groups[0].rm_eo = len;
+	flags |= REG_STARTEND;
+	#endif
+
+	if((res = regexec(&re->reg, cursor, re->groups, groups, flags))){
+		if(err != NULL){
+			err->code = res;
+			regerror(res, &re->reg, (char*)err->msg, 300);
+		}
+	}
+
+	return res;
+}
+
+// !trivial
+// report the status of the last search, running out of matches isn't an error
+static void string_regex_status(const string_regex_t *re, int status, error_t *err){
+	if(err == NULL) return;
+
+	if(status == 0 || status == REG_NOMATCH){
+		*err = (error_t){.code = 0, .msg = "ok"};
+		return;
+	}
+
+	err->code = status;
+	if(re->dfa != NULL)
+		strcpy(err->msg, "Regex error");
+	else
+		regerror(status, &re->reg, err->msg, sizeof(err->msg));
+}
+
+// !trivial
+string_match_t string_match_ite_next(string_match_ite *iterator){
+	string_match_t match = {0};
+	string_regex_t *re = iterator->re;
+
+	if(re == NULL || iterator->state >= iterator->end){
+		iterator->yield = false;
+		return match;
+	}
+
+	regmatch_t groups[re->groups];
+	iterator->status = string_regex_exec(re, iterator->state, iterator->end - iterator->state, groups, NULL);
+	if(iterator->status){
+		iterator->yield = false;
+		return match;
+	}
+
+	size_t offset = iterator->state - iterator->base;
+	match.groupsSize = re->groups < STRING_MATCH_MAX_GROUPS ? re->groups : STRING_MATCH_MAX_GROUPS;
+	for(size_t i = 0; i < match.groupsSize; i++){
+		if(groups[i].rm_so == -1)
+			match.groups[i] = (string_span_t){.offset = SIZE_MAX, .len = 0};
+		else
+			match.groups[i] = (string_span_t){.offset = offset + groups[i].rm_so, .len = groups[i].rm_eo - groups[i].rm_so};
+	}
+
+	// after end of match, step over one character on empty matches so the iterator advances
+	iterator->state += groups[0].rm_eo;
+	if(groups[0].rm_eo == groups[0].rm_so)
+		iterator->state++;
+
+	return match;
+}
+
+string_match_ite string_regex_matches(const string *str, const string_regex_t *re){
+	return (string_match_ite){
+		.next = string_match_ite_next,
+		.yield = true,
+		.re = (string_regex_t*)re,
+		.base = str->raw,
+		.state = str->raw,
+		.end = str->raw + str->len,
+		.cached = false,
+		.status = 0
+	};
+}
+
+string string_match_group(const string *str, const string_match_t *match, size_t group){
+	if(group >= match->groupsSize || match->groups[group].offset == SIZE_MAX)
+		return (string){0};
+
+	return (string){
+		.raw = str->raw + match->groups[group].offset,
+		.len = match->groups[group].len,
+		.allocated = 0,
+		.owns = false
+	};
+}
+
+// !trivial
+string *_string_replace_all(const string *str, const string_regex_t *re, const char *replace, size_t max, error_t *err){
+	regmatch_t groups[re->groups];
+	string *replaced = string_new_sized(str->len + STRING_ALLOCATION_CHUNK);
+
+	// match again and again 
+	char *cursor = str->raw;
+	char *last = str->raw + str->len;
+	int status = 0;
+	for(size_t m = 0; (max == 0 || m < max) && (cursor < last); m++){
+		if((status = string_regex_exec(re, cursor, last - cursor, groups, err)))
+			break;
+
+		// add original string
+		_string_cat_raw(replaced, cursor, groups[0].rm_so);
+
+		// substitute groups
+		char *replaceCursor = (char*)replace;
+		char *endText;
+		char *end;
+		int id = getGroupId(replaceCursor, &endText, &end);
+		while(replaceCursor != NULL){
+			_string_cat_raw(replaced, (const char *)replaceCursor, endText != NULL ? (size_t)(endText - replaceCursor) : strlen(replaceCursor));
+
+			// skip groups that didn't participate in the match
+			if(id > -1 && (size_t)id < re->groups && groups[id].rm_so != -1)
+				_string_cat_raw(replaced, cursor + groups[id].rm_so, groups[id].rm_eo - groups[id].rm_so);
+
+			replaceCursor = end;
+			id = getGroupId(replaceCursor, &endText, &end);
 		}
 
 		// after end of last match
 		cursor = cursor + groups[0].rm_eo;
+
+		// empty match, step over one character so the loop advances
+		if(groups[0].rm_eo == groups[0].rm_so && cursor < last){
+			_string_cat_raw(replaced, cursor, 1);
+			cursor++;
+		}
     }
 
-	// regfree(&reg);
-	if(err != NULL) *err = (error_t){.code = 0, .msg = "ok"};
-	return ret;
+	// append rest on exit
+	_string_cat_raw(replaced, cursor, last - cursor);
+
+	string_regex_status(re, status, err);
+	return replaced;
+}
+
+string *string_regex_replaceAll(const string *str, const string_regex_t *re, const char *replace, size_t maxReplaces, error_t *error){
+	if(re == NULL) return NULL;
+	return _string_replace_all(str, re, replace, maxReplaces, error);
+}
+
+string *string_regex_replace(const string *str, const string_regex_t *re, const char *replace, error_t *error){
+	return string_regex_replaceAll(str, re, replace, 1, error);
+}
+
+array_t *string_regex_matchAll(const string *str, const string_regex_t *re, size_t maxMatches, error_t *error){
+	if(re == NULL) return NULL;
+
+	array_t *matches = array_new_custom(true, MIN_ARRAY_BLOCK_SIZE);
+	string_match_ite ite = string_regex_matches(str, re);
+	size_t m = 0;
+	for(string_match_t match = next(ite); yield(ite); match = next(ite)){
+		string *slice = malloc(sizeof(string));
+		*slice = string_match_group(str, &match, 0);
+		array_add(matches, slice);
+
+		if(++m == maxMatches)
+			break;
+	}
+
+	string_regex_status(re, ite.status, error);
+	return matches;
+}
+
+string string_regex_match(const string *str, const string_regex_t *re, error_t *error){
+	if(re == NULL) return (string){0};
+
+	string_match_ite ite = string_regex_matches(str, re);
+	string_match_t match = next(ite);
+	string_regex_status(re, ite.status, error);
+	return yield(ite) ? string_match_group(str, &match, 0) : (string){0};
 }
 
 string *string_replaceAll(const string *str, const char *regex, const char *replace, size_t maxReplaces, error_t *error){
-	matches_and_replaced_t mr = _string_match_replace_all(str, regex, replace, maxReplaces, false, true, error);
-	return mr.replaced;
+	string_regex_t *re = string_regex_cache_acquire(regex, error);
+	if(re == NULL) return NULL;
+	string *ret = string_regex_replaceAll(str, re, replace, maxReplaces, error);
+	string_regex_cache_release(re);
+	return ret;
 }
 
 string *string_replace(const string *str, const char *regex, const char *replace, error_t *error){
-	matches_and_replaced_t mr = _string_match_replace_all(str, regex, replace, 1, false, true, error);
-	return mr.replaced;
+	return string_replaceAll(str, regex, replace, 1, error);
 }
 
 array_t *string_matchAll(const string *str, const char *regex, size_t maxMatches, error_t *error){
-	matches_and_replaced_t mr = _string_match_replace_all(str, regex, NULL, maxMatches, true, false, error);
+	string_regex_t *re = string_regex_cache_acquire(regex, error);
+	if(re == NULL) return NULL;
+	array_t *ret = string_regex_matchAll(str, re, maxMatches, error);
+	string_regex_cache_release(re);
+	return ret;
+}
 
-	array_t *ret = array_new_custom(true, mr.matchesSize);
-	for(size_t i = 0; i < mr.matchesSize; i++)
-		array_set(ret, i, mr.matches[i]);
+string_match_ite string_matches(const string *str, const char *regex, error_t *error){
+	string_match_ite ite = string_regex_matches(str, string_regex_cache_acquire(regex, error));
+	ite.cached = true;
+	if(ite.re == NULL)
+		ite.yield = false;
 
-	free(mr.matches);
-	return ret;
+	return ite;
+}
+
+void string_matches_close(string_match_ite *ite){
+	if(ite->cached && ite->re != NULL)
+		string_regex_cache_release(ite->re);
+
+	ite->re = NULL;
+	ite->yield = false;
 }
 
 string string_match(const string *str, const char *regex, error_t *error){
-	matches_and_replaced_t mr = _string_match_replace_all(str, regex, NULL, 1, true, false, error);
-	string ret = *mr.matches[0];
-	free(mr.matches);
+	string_regex_t *re = string_regex_cache_acquire(regex, error);
+	if(re == NULL) return (string){0};
+	string ret = string_regex_match(str, re, error);
+	string_regex_cache_release(re);
 	return ret;
-}
\ No newline at end of file
+}
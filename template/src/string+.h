@@ -7,18 +7,35 @@
 #include <stdbool.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <regex.h>
 #include "data.h"
+#include "regex_dfa.h"
 #include "error.h"
 #include "ite.h"
 
 // ------------------------------------------------------------ Defines ------------------------------------------------------------
 
-// ammount of data to intialize strings and realloc by
+// ammount of data to intialize strings and the minimum to grow by, strings double in size after it
 #define STRING_ALLOCATION_CHUNK 1024
 
 // ammount of characters to return from split iterator
 #define STRING_SPLIT_MAX_SIZE 2048
 
+// maximum number of characters 'string_to_int', 'string_to_uint' and 'string_to_double' read from a string
+#define STRING_NUMBER_MAX_SIZE 128
+
+// maximum number of tokens 'string_split' scans with SIMD compares instead of the token bit map
+#define STRING_SPLIT_FAST_TOKENS 4
+
+// ammount of data read at a time from FILEs that can't be seeked, like pipes, and initial buffer size of the line iterator
+#define STRING_READ_CHUNK (64 * 1024)
+
+// maximum number of capture slots kept in a 'string_match_t', the whole match plus the first groups of the pattern
+#define STRING_MATCH_MAX_GROUPS 16
+
+// maximum number of compiled patterns kept by 'string_matchAll', 'string_replaceAll' and friends
+#define STRING_REGEX_CACHE_SIZE 64
+
 // ansi escape define foreground color
 #define FOREGROUND_COLOR "\x1b[38;2;%d;%d;%dm"
 
@@ -38,8 +55,20 @@ typedef struct{
 	size_t len;
 	bool owns;
 	size_t allocated;
+	bool mapped;
+	bool inlined;											/**< 'raw' lives in the header allocation or in a caller buffer and isn't freed on it's own */
+	arena_t *arena;											/**< header and buffer are allocated from it when not NULL */
 }string;
 
+/**
+ * @brief flags for 'string_map_filename'
+*/
+typedef enum{
+	string_map_default    = 0,
+	string_map_populate   = 1 << 0,							/**< prefault the whole file into memory on map (MAP_POPULATE) */
+	string_map_sequential = 1 << 1,							/**< hint the kernel that the file will be read sequentially (MADV_SEQUENTIAL) */
+}string_map_flags_t;
+
 /**
  * @brief string iterator type. Created by functions like: 'string_split', etc.
  * Can be used with subsequent calls of 'string_next(&string_ite)' to get new values from the iterator. 
@@ -54,6 +83,96 @@ struct string_ite{
 	char *base;
 	char *state;
 	size_t max;
+	uint64_t set[4];										/**< token set compiled as a 256 bit map, one bit per byte value */
+	char delimiters[STRING_SPLIT_FAST_TOKENS];				/**< the tokens, when there are few enough to be scanned with SIMD compares */
+	size_t delimitersSize;									/**< 0 when the token set is too big and the bit map is used */
+};
+
+/**
+ * @brief line iterator over a FILE. Created by 'string_file_lines'.
+ * Reads the file in chunks of 'STRING_READ_CHUNK', carrying over partial lines to the next chunk, so memory stays bounded by the longest line
+*/
+typedef struct string_file_ite string_file_ite;
+typedef string (*string_file_ite_next_func)(string_file_ite *ite);
+struct string_file_ite{
+	string_file_ite_next_func next;
+	bool yield;
+	FILE *file;
+	char *buffer;
+	size_t allocated;
+	size_t start;
+	size_t end;
+	bool eof;
+};
+
+/**
+ * @brief integer iterator over a string. Created by 'string_ints'
+*/
+typedef struct string_int_ite string_int_ite;
+typedef int64_t (*string_int_ite_next_func)(string_int_ite *ite);
+struct string_int_ite{
+	string_int_ite_next_func next;
+	bool yield;
+	const char *base;
+	const char *state;
+	const char *end;
+};
+
+/**
+ * @brief line offset index of a string. Created by 'string_lines_index'. Line 'n' starts at 'starts[n]',
+ * 'starts[count]' is a sentinel one past the '\n' ending the last line, so the length of line 'n' is always 'starts[n + 1] - starts[n] - 1'
+*/
+typedef struct{
+	const char *base;
+	size_t *starts;
+	size_t count;
+}string_lines_t;
+
+/**
+ * @brief compiled regex. Created by 'string_regex_compile', use it to match the same pattern many times without recompiling it.
+ * Patterns are matched by the built in lazy DFA engine of 'regex_dfa.h' when they fit it's subset, by POSIX 'regexec' otherwise
+*/
+typedef struct{
+	regex_dfa_t *dfa;										/**< NULL when using POSIX regex */
+	regex_t reg;
+	char *pattern;
+	size_t groups;											/**< capture slots: the whole match plus one for each group in the pattern */
+	size_t refs;											/**< users of a cached regex, see 'STRING_REGEX_CACHE_SIZE' */
+	bool cached;
+}string_regex_t;
+
+/**
+ * @brief position of a match or group inside the matched string
+*/
+typedef struct{
+	size_t offset;											/**< SIZE_MAX when the group didn't participate in the match */
+	size_t len;
+}string_span_t;
+
+/**
+ * @brief a regex match, returned by value from 'string_match_ite'. 'groups[0]' is the whole match and 'groups[n]' the n-th group of the pattern,
+ * use 'string_match_group' to get them as slices
+*/
+typedef struct{
+	string_span_t groups[STRING_MATCH_MAX_GROUPS];
+	size_t groupsSize;
+}string_match_t;
+
+/**
+ * @brief regex match iterator over a string. Created by 'string_regex_matches' and 'string_matches'.
+ * Matches are found lazily, one per 'next', without allocating
+*/
+typedef struct string_match_ite string_match_ite;
+typedef string_match_t (*string_match_ite_next_func)(string_match_ite *ite);
+struct string_match_ite{
+	string_match_ite_next_func next;
+	bool yield;
+	string_regex_t *re;
+	const char *base;
+	const char *state;
+	const char *end;
+	bool cached;											/**< 're' was taken from the regex cache and is released by 'string_matches_close' */
+	int status;												/**< result of the last search: 0, 'REG_NOMATCH' or the 'regexec' error that stopped the iterator */
 };
 
 // ------------------------------------------------------------ Constructors -------------------------------------------------------
@@ -64,10 +183,42 @@ struct string_ite{
 string *string_new();
 
 /**
- * @brief create new string with predefined allocated size
+ * @brief create new string with predefined allocated size. The header and the buffer are allocated together
 */
 string *string_new_sized(size_t size);
 
+/**
+ * @brief create a string value that uses 'buffer' as storage, without allocating. Use it for strings on the stack or inside other structs.
+ * The string works with every function taking a 'string*', when it outgrows 'buffer' it moves to the heap,
+ * so release it with 'string_free', never with 'string_destroy'
+ * @param buffer: storage for the string, must outlive it
+ * @param size: size of 'buffer', the null terminator included
+ * @details
+ * char buffer[64];
+ * string name = string_with_buffer(buffer, sizeof(buffer));
+ * string_cat_raw(&name, "abc", 3);
+ * string_free(&name);
+*/
+string string_with_buffer(char *buffer, size_t size);
+
+/**
+ * @brief create new string allocated from an arena, it grows inside the arena too.
+ * 'string_destroy' doesn't free anything, the memory is released with the arena
+ * @param arena: arena to allocate from, must outlive the string
+ * @param size: initial allocated size
+*/
+string *string_new_arena(arena_t *arena, size_t size);
+
+/**
+ * @brief same as 'string_from' but allocated from an arena
+*/
+string *string_from_arena(arena_t *arena, const char *str);
+
+/**
+ * @brief same as 'string_copy' but allocated from an arena. Useful to keep slices around after the source string is freed
+*/
+string *string_copy_arena(arena_t *arena, const string *str);
+
 /**
  * @brief create a copy from another string
 */
@@ -96,7 +247,8 @@ string *string_vsprint(const char *fmt, size_t max_size, va_list args);
 string *string_sprint(const char *fmt, size_t max_size, ...);
 
 /**
- * @brief create string from FILE pointer
+ * @brief create string from FILE pointer. The FILE is closed afterwards.
+ * Works on pipes and other non seekable FILEs, like stdin, by reading in chunks and growing the string geometrically
  * @param file: FILE* descriptor. Made by using fopen
  * @param read: size read form file
 */
@@ -109,13 +261,29 @@ string *string_from_file(FILE *file, size_t *read);
 */
 string *string_from_filename(const char *filename, size_t *read);
 
+/**
+ * @brief create a read only string that maps a file named filename straight from the page cache, without copying it
+ * The string is always null terminated, it can't be written to or concatenated and 'string_destroy' unmaps it.
+ * Files that can't be mapped, like pipes, '/dev/stdin' or '/proc' files, are read into a normal string instead
+ * @return NULL if the file can't be opened or stat'd
+ * @param filename: the filesystem name of the file relative to executable
+ * @param read: size read form file
+ * @param flags: 'string_map_flags_t' ORed together. Ex: 'string_map_populate | string_map_sequential'
+*/
+string *string_map_filename(const char *filename, size_t *read, string_map_flags_t flags);
+
 // ------------------------------------------------------------ Destructors --------------------------------------------------------
 
 /**
- * @brief deallocate a string
+ * @brief deallocate a string. Strings made with 'string_map_filename' are unmapped
 */
 void string_destroy(string *str);
 
+/**
+ * @brief free the buffer of a string value, like the ones from 'string_with_buffer', and leave it empty. The string itself is not freed
+*/
+void string_free(string *str);
+
 /**
  * @brief return c string and free string structure 
 */
@@ -133,7 +301,9 @@ char *string_unwrap(string *str);
 string string_slice(const string *str, int from, unsigned int len);
 
 /**
- * @brief split string based on token list
+ * @brief split string based on token list. Empty slices between consecutive tokens are skipped.
+ * The token set is compiled once, a single token is searched with 'memchr' and up to 'STRING_SPLIT_FAST_TOKENS' with SIMD compares.
+ * Scanning is bounded by the string length, so slices can be split too
  * @param string: string to split
  * @param tokens: string containing tokens
  * @return string iterator, use the 'iterator.next(&iterator)' member to grab the string slices until 'iterator.yield' becomes false. Try using the 'foreach' macro!
@@ -146,6 +316,51 @@ string string_slice(const string *str, int from, unsigned int len);
 */
 string_ite string_split(const string *str, const char *tokens);
 
+/**
+ * @brief iterate over the lines of a FILE, one line at a time, without loading it whole. Works on pipes, like stdin
+ * @param file: FILE* descriptor. Not closed by the iterator
+ * @return line iterator, use 'next(ite)' to grab the lines until 'yield(ite)' becomes false. Empty lines are also returned.
+ * The returned slices don't contain the '\n' and are only valid until the next call to 'next'. 
+ * The iterator frees it's buffer when done, call 'string_file_lines_close' if stopping early
+ * @details
+ * string_file_ite ite = string_file_lines(stdin);
+ * for(string line = next(ite); yield(ite); line = next(ite)){
+ * 		string_println(&line);
+ * }
+*/
+string_file_ite string_file_lines(FILE *file);
+
+/**
+ * @brief free the line iterator buffer, only needed when stopping before 'yield' becomes false
+*/
+void string_file_lines_close(string_file_ite *ite);
+
+/**
+ * @brief index the start of every line of a string in a single pass, for O(1) access to any line and the line count up front.
+ * Empty lines are also indexed and a '\n' at the very end doesn't start a new line. The scan is bounded by the string length
+ * @param str: string to index. Must outlive the index
+ * @return the index, free it with 'string_lines_destroy'
+ * @details
+ * string_lines_t lines = string_lines_index(input);
+ * for(size_t i = 0; i < lines.count; i++){
+ * 		string line = string_lines_at(&lines, i);
+ * }
+ * string_lines_destroy(&lines);
+*/
+string_lines_t string_lines_index(const string *str);
+
+/**
+ * @brief get the line 'n' of an index, without the '\n'
+ * @return a string slice of the indexed string, empty if 'n' is out of range
+ * @attention O(1)
+*/
+string string_lines_at(const string_lines_t *lines, size_t n);
+
+/**
+ * @brief free a line index
+*/
+void string_lines_destroy(string_lines_t *lines);
+
 // ------------------------------------------------------------ C String functions -------------------------------------------------
 
 // char *strdup(const char *str){
@@ -162,6 +377,12 @@ string_ite string_split(const string *str, const char *tokens);
 */
 size_t string_length(const string* str);
 
+/**
+ * @brief make sure the string can hold 'size' characters without reallocating. Grows geometrically.
+ * @return false if the string can't grow, like slices and mapped strings
+*/
+bool string_reserve(string *str, size_t size);
+
 /**
  * @brief write formatted text to string
 */
@@ -252,6 +473,32 @@ uint64_t string_to_uint(const string *str, uint32_t base);
 */
 double string_to_double(const string *str);
 
+/**
+ * @brief extract every base 10 integer in the string, in a single pass. Anything that isn't a digit is a separator
+ * and a '-' right before the digits makes the number negative. Numbers bigger than 'INT64_MAX' wrap around.
+ * Digits are parsed 8 at a time when possible and the scan is bounded by the string length, so slices can be parsed too
+ * @param str: string to parse
+ * @param out: buffer to write the integers to
+ * @param max: size of 'out'. Parsing stops when 'out' is full
+ * @return the number of integers written to 'out'
+ * @details
+ * // "mul(12,-5) 300" -> {12, -5, 300}
+ * int64_t values[3];
+ * size_t count = string_parse_ints(str, values, 3);
+*/
+size_t string_parse_ints(const string *str, int64_t *out, size_t max);
+
+/**
+ * @brief streaming version of 'string_parse_ints'. Same parsing rules, but yields one integer at a time
+ * @return integer iterator, use 'next(ite)' to grab the integers until 'yield(ite)' becomes false
+ * @details
+ * string_int_ite ite = string_ints(line);
+ * for(int64_t n = next(ite); yield(ite); n = next(ite)){
+ * 		sum += n;
+ * }
+*/
+string_int_ite string_ints(const string *str);
+
 /**
  * @brief replace all 'regex' occurances in 'str' with the pattern 'replace'
  * @param str: string to process
@@ -288,8 +535,84 @@ array_t *string_matchAll(const string *str, const char *regex, size_t maxMatches
  * @param str: string to process
  * @param regex: regex to use. Uses 'REG_EXTENDED' and 'REG_NEWLINE' by default
  * @param error: Pass an '&error_t' to receive error data. Pass NULL to ignore 
- * @return returns a string slice from the original string, Don't alter it!
+ * @return returns a string slice from the original string, Don't alter it! An empty string if nothing matched
 */
 string string_match(const string *str, const char *regex, error_t *error);
 
+/**
+ * @brief compile a regex to be used with the 'string_regex_*' functions
+ * @param regex: regex to compile. Uses 'REG_EXTENDED' and 'REG_NEWLINE' by default. '\d', '\w', '\s' and their negations '\D', '\W', '\S'
+ * are supported outside of brackets, patterns the built in engine doesn't handle have them rewritten as POSIX classes for 'regcomp'
+ * @param error: Pass an '&error_t' to receive error data. Pass NULL to ignore 
+ * @return the compiled regex or NULL on error. Free it with 'string_regex_destroy'
+*/
+string_regex_t *string_regex_compile(const char *regex, error_t *error);
+
+/**
+ * @brief free a regex compiled with 'string_regex_compile'
+*/
+void string_regex_destroy(string_regex_t *re);
+
+/**
+ * @brief same as 'string_replaceAll' but with a compiled regex
+*/
+string *string_regex_replaceAll(const string *str, const string_regex_t *re, const char *replace, size_t maxReplaces, error_t *error);
+
+/**
+ * @brief same as 'string_replace' but with a compiled regex
+*/
+string *string_regex_replace(const string *str, const string_regex_t *re, const char *replace, error_t *error);
+
+/**
+ * @brief same as 'string_matchAll' but with a compiled regex
+*/
+array_t *string_regex_matchAll(const string *str, const string_regex_t *re, size_t maxMatches, error_t *error);
+
+/**
+ * @brief same as 'string_match' but with a compiled regex
+*/
+string string_regex_match(const string *str, const string_regex_t *re, error_t *error);
+
+/**
+ * @brief iterate over all 're' occurances in 'str', without allocating. Matches and groups are reported as offsets into 'str'
+ * @param str: string to process. Must outlive the iterator
+ * @param re: compiled regex. Must outlive the iterator
+ * @return match iterator, use 'next(ite)' to grab the matches until 'yield(ite)' becomes false
+ * @details
+ * string_regex_t *mul = string_regex_compile("mul\\(([0-9]{1,3}),([0-9]{1,3})\\)", NULL);
+ * string_match_ite ite = string_regex_matches(input, mul);
+ * for(string_match_t m = next(ite); yield(ite); m = next(ite)){
+ * 		string a = string_match_group(input, &m, 1);
+ * 		string b = string_match_group(input, &m, 2);
+ * 		sum += string_to_int(&a, 10) * string_to_int(&b, 10);
+ * }
+*/
+string_match_ite string_regex_matches(const string *str, const string_regex_t *re);
+
+/**
+ * @brief same as 'string_regex_matches' but compiles the pattern through the regex cache. Release it with 'string_matches_close'
+ * @param error: Pass an '&error_t' to receive error data. Pass NULL to ignore. On error the iterator yields nothing
+*/
+string_match_ite string_matches(const string *str, const char *regex, error_t *error);
+
+/**
+ * @brief release the regex held by an iterator from 'string_matches'. Does nothing for 'string_regex_matches' iterators
+*/
+void string_matches_close(string_match_ite *ite);
+
+/**
+ * @brief get a match group as a slice of the matched string
+ * @param str: the string that was matched
+ * @param match: the match
+ * @param group: 0 for the whole match, n for the n-th group
+ * @return a string slice, empty if the group didn't participate in the match or is past 'STRING_MATCH_MAX_GROUPS'
+*/
+string string_match_group(const string *str, const string_match_t *match, size_t group);
+
+/**
+ * @brief free all the regexes cached by 'string_matchAll', 'string_replaceAll' and friends. 
+ * The cache is thread safe and keeps the 'STRING_REGEX_CACHE_SIZE' most recently used patterns
+*/
+void string_regex_cache_clear(void);
+
 #endif
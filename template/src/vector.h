@@ -0,0 +1,142 @@
+#ifndef _VECTOR_HEADER_
+#define _VECTOR_HEADER_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file Typed dynamic arrays generated by a macro. Elements are stored inline and contiguous, so ints and points
+ * don't need to be boxed like with 'array_t'. Storage grows geometrically.
+ * @details
+ * VECTOR_DEFINE(pointvec, point_t)
+ *
+ * pointvec_t *v = pointvec_new(0);
+ * pointvec_push(v, (point_t){y, x});
+ * for(size_t i = 0; i < v->size; i++)
+ * 	 visit(v->data[i]);
+ * pointvec_destroy(v);
+*/
+
+// ------------------------------------------------------------ Defines ------------------------------------------------------------
+
+#define VECTOR_MIN_CAPACITY 16
+
+// ------------------------------------------------------------ Vector -------------------------------------------------------------
+
+/**
+ * @brief define the type 'name_t', a vector of 'T', and it's functions:
+ * - name_t *name_new(size_t capacity): 0 for the default
+ * - void name_destroy(name_t *v)
+ * - size_t name_size(const name_t *v)
+ * - void name_reserve(name_t *v, size_t capacity): make room for at least 'capacity' elements
+ * - void name_resize(name_t *v, size_t size): new elements are zeroed
+ * - void name_clear(name_t *v): remove all elements, keeping the memory
+ * - size_t name_push(name_t *v, T value): append, returns the position
+ * - void name_append(name_t *v, const T *values, size_t count): append 'count' elements at once
+ * - T *name_at(const name_t *v, size_t pos): pointer to the element or NULL if out of bounds
+ * - T name_get(const name_t *v, size_t pos): the element, 'pos' must be in bounds
+ * - void name_set(name_t *v, size_t pos, T value): 'pos' must be in bounds
+ * - T name_pop(name_t *v): remove the last element, the vector must not be empty
+ * - void name_insert(name_t *v, size_t pos, T value): O(n)
+ * - T name_erase(name_t *v, size_t pos): remove keeping the order. O(n)
+ * - T name_swap_remove(name_t *v, size_t pos): remove by moving the last element into 'pos'. O(1)
+ *
+ * Elements can also be accessed directly through 'data' and 'size'. Pointers into 'data' are invalidated when it grows
+*/
+#define VECTOR_DEFINE(name, T)																					\
+																												\
+typedef struct{																									\
+	T *data;																									\
+	size_t size;																								\
+	size_t capacity;																							\
+}name##_t;																										\
+																												\
+static inline name##_t *name##_new(size_t capacity){															\
+	name##_t *v = malloc(sizeof(name##_t));																		\
+	v->size = 0;																								\
+	v->capacity = capacity > 0 ? capacity : VECTOR_MIN_CAPACITY;												\
+	v->data = malloc(v->capacity * sizeof(T));																	\
+	return v;																									\
+}																												\
+																												\
+static inline void name##_destroy(name##_t *v){																	\
+	if(v == NULL) return;																						\
+	free(v->data);																								\
+	free(v);																									\
+}																												\
+																												\
+static inline size_t name##_size(const name##_t *v){															\
+	return v->size;																								\
+}																												\
+																												\
+static inline void name##_reserve(name##_t *v, size_t capacity){												\
+	if(capacity <= v->capacity) return;																			\
+	size_t grown = v->capacity * 2;																				\
+	v->capacity = capacity > grown ? capacity : grown;															\
+	v->data = realloc(v->data, v->capacity * sizeof(T));														\
+}																												\
+																												\
+static inline void name##_resize(name##_t *v, size_t size){													\
+	name##_reserve(v, size);																					\
+	if(size > v->size)																							\
+		memset(v->data + v->size, 0, (size - v->size) * sizeof(T));												\
+	v->size = size;																								\
+}																												\
+																												\
+static inline void name##_clear(name##_t *v){																	\
+	v->size = 0;																								\
+}																												\
+																												\
+static inline size_t name##_push(name##_t *v, T value){														\
+	if(v->size == v->capacity)																					\
+		name##_reserve(v, v->size + 1);																			\
+	v->data[v->size] = value;																					\
+	return v->size++;																							\
+}																												\
+																												\
+static inline void name##_append(name##_t *v, const T *values, size_t count){								\
+	name##_reserve(v, v->size + count);																			\
+	memcpy(v->data + v->size, values, count * sizeof(T));														\
+	v->size += count;																							\
+}																												\
+																												\
+static inline T *name##_at(const name##_t *v, size_t pos){													\
+	return pos < v->size ? &v->data[pos] : NULL;																\
+}																												\
+																												\
+static inline T name##_get(const name##_t *v, size_t pos){													\
+	return v->data[pos];																						\
+}																												\
+																												\
+static inline void name##_set(name##_t *v, size_t pos, T value){												\
+	v->data[pos] = value;																						\
+}																												\
+																												\
+static inline T name##_pop(name##_t *v){																		\
+	return v->data[--v->size];																					\
+}																												\
+																												\
+static inline void name##_insert(name##_t *v, size_t pos, T value){											\
+	if(v->size == v->capacity)																					\
+		name##_reserve(v, v->size + 1);																			\
+	memmove(v->data + pos + 1, v->data + pos, (v->size - pos) * sizeof(T));										\
+	v->data[pos] = value;																						\
+	v->size++;																									\
+}																												\
+																												\
+static inline T name##_erase(name##_t *v, size_t pos){														\
+	T value = v->data[pos];																						\
+	memmove(v->data + pos, v->data + pos + 1, (v->size - pos - 1) * sizeof(T));									\
+	v->size--;																									\
+	return value;																								\
+}																												\
+																												\
+static inline T name##_swap_remove(name##_t *v, size_t pos){													\
+	T value = v->data[pos];																						\
+	v->data[pos] = v->data[--v->size];																			\
+	return value;																								\
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define _WORKER_HEADER_
 
 /**
- * @file Don't forget to link against '-lpthread'
+ * @file Don't forget to link against '-lpthread'. Functions are static inline so the header can be included by more than one source file
 */
 
 #include <stdlib.h>
@@ -17,13 +17,13 @@ typedef struct{
 	void *ret;
 }worker_t;
 
-void *workerWrapFunction(void *data){
+static inline void *workerWrapFunction(void *data){
 	worker_t *worker = (worker_t*)data;
 	worker->ret = worker->workerFunction(worker->data);
 	return 0;
 }
 
-worker_t *workerCreate(workerFunction_t workerFunction, void *data){
+static inline worker_t *workerCreate(workerFunction_t workerFunction, void *data){
 	worker_t *worker = malloc(sizeof(worker_t));
 	worker->data = data;
 	worker->workerFunction = workerFunction;
@@ -33,7 +33,7 @@ worker_t *workerCreate(workerFunction_t workerFunction, void *data){
 	return worker;
 }
 
-void *workerWait(worker_t *worker){
+static inline void *workerWait(worker_t *worker){
 	pthread_join(worker->thread, NULL);
 	void *ret = worker->ret;
 	free(worker);